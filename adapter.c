@@ -0,0 +1,529 @@
+/*
+Documentation
+Name       :G Gangadhar
+Date       :30/07/2025
+Description:Steganography project
+*/
+#define _GNU_SOURCE // fopencookie
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "adapter.h"
+#include "arena.h"
+#include "types.h"
+
+typedef struct _AdapterStream
+{
+    int fd;                                   // The native image
+    unsigned char head[ADAPTER_BMP_HEADER];   // Synthesized BMP header
+    long long width, height;
+    int pixel_bytes;                          // 3, or 4 for 32 bpp TGA
+    int flip;                                 // Native rows run top-down
+    int swap;                                 // Native pixels are R, G, B
+    long long row_bytes;                      // Native row: width * pixel_bytes
+    long long stride;                         // View row: row_bytes, or padded to four bytes
+    long long native_head;                    // Bytes ahead of the native pixels
+    long long pixels_end;                     // View offset past the last row
+    long long pos;                            // Stream position
+    long long size;                           // View bytes
+    unsigned char *buffer;                    // ADAPTER_CHUNK native bytes being converted
+} AdapterStream;
+
+ImageFormat image_format(const char *fname)
+{
+    const char *extn = strrchr(fname, '.');
+
+    if (extn == NULL)
+    {
+        return e_format_unknown;
+    }
+    if (strcmp(extn, ".bmp") == 0)
+    {
+        return e_format_bmp;
+    }
+    if (strcmp(extn, ".ppm") == 0)
+    {
+        return e_format_ppm;
+    }
+    if (strcmp(extn, ".tga") == 0)
+    {
+        return e_format_tga;
+    }
+    if (strcmp(extn, ".rgb") == 0 || strcmp(extn, ".raw") == 0)
+    {
+        return e_format_raw;
+    }
+    return e_format_unknown;
+}
+
+Status parse_raw_size(const char *arg, uint *width, uint *height)
+{
+    char end;
+
+    if (sscanf(arg, "%ux%u%c", width, height, &end) != 2 || *width == 0 || *height == 0)
+    {
+        return e_failure;
+    }
+    return e_success;
+}
+
+// Next PPM header number, skipping white space and comments
+static long long ppm_number(const unsigned char *head, long long len, long long *at)
+{
+    long long value = 0;
+
+    while (*at < len && (isspace(head[*at]) || head[*at] == '#'))
+    {
+        if (head[*at] == '#')
+        {
+            while (*at < len && head[*at] != '\n')
+            {
+                (*at)++;
+            }
+        }
+        else
+        {
+            (*at)++;
+        }
+    }
+    if (*at >= len || !isdigit(head[*at]))
+    {
+        return -1;
+    }
+    while (*at < len && isdigit(head[*at]) && value < (1LL << 32))
+    {
+        value = value * 10 + head[(*at)++] - '0';
+    }
+    return value;
+}
+
+// Pixel layout of the native image from its header
+static Status read_layout(AdapterStream *as, const char *fname, ImageFormat format, uint raw_width, uint raw_height, int padded)
+{
+    unsigned char head[ADAPTER_MAX_HEADER];
+    long long len = pread(as->fd, head, sizeof(head), 0);
+
+    if (format == e_format_ppm)
+    {
+        long long at = 2, maxval;
+        if (len < 2 || head[0] != 'P' || head[1] != '6')
+        {
+            printf("ERROR: ❌ %s is not a binary (P6) PPM image\n", fname);
+            return e_failure;
+        }
+        as->width = ppm_number(head, len, &at);
+        as->height = ppm_number(head, len, &at);
+        maxval = ppm_number(head, len, &at);
+        // A single white space character ends the header
+        if (as->width <= 0 || as->height <= 0 || maxval <= 0 || at >= len || !isspace(head[at]))
+        {
+            printf("ERROR: ❌ Unreadable PPM header in %s\n", fname);
+            return e_failure;
+        }
+        if (maxval > 255)
+        {
+            printf("ERROR: ❌ %s has 16-bit samples; only PPM images with maxval up to 255 are supported\n", fname);
+            return e_failure;
+        }
+        as->native_head = at + 1;
+        as->pixel_bytes = 3;
+        as->flip = 1;
+        as->swap = 1;
+    }
+    else if (format == e_format_tga)
+    {
+        if (len < 18 || head[1] != 0 || head[2] != 2 || (head[16] != 24 && head[16] != 32) || (head[17] & 0x10))
+        {
+            printf("ERROR: ❌ %s is not an uncompressed, left-to-right true colour TGA image of 24 or 32 bpp\n", fname);
+            return e_failure;
+        }
+        as->width = head[12] | head[13] << 8;
+        as->height = head[14] | head[15] << 8;
+        as->native_head = 18 + head[0]; // Header and image ID
+        as->pixel_bytes = head[16] / 8;
+        as->flip = (head[17] & 0x20) != 0;
+        as->swap = 0;
+    }
+    else
+    {
+        as->width = raw_width;
+        as->height = raw_height;
+        as->native_head = 0;
+        as->pixel_bytes = 3;
+        as->flip = 1;
+        as->swap = 1;
+    }
+    if (as->width <= 0 || as->height <= 0 || as->width > 0x7FFFFFFF || as->height > 0x7FFFFFFF)
+    {
+        printf("ERROR: ❌ %s has no pixels, or is wider or taller than a BMP can be\n", fname);
+        return e_failure;
+    }
+
+    as->row_bytes = as->width * as->pixel_bytes;
+    as->stride = padded ? (as->row_bytes + 3) & ~3LL : as->row_bytes;
+    as->pixels_end = ADAPTER_BMP_HEADER + as->stride * as->height;
+    return e_success;
+}
+
+// The BMP header the image would convert to; sizes are the view's
+static void build_head(AdapterStream *as)
+{
+    unsigned char *h = as->head;
+    long long image = as->stride * as->height;
+    uint fields[] = {as->size > 0xFFFFFFFFLL ? 0 : (uint)as->size, 0, ADAPTER_BMP_HEADER, 40, (uint)as->width, (uint)as->height};
+    int i;
+
+    memset(h, 0, ADAPTER_BMP_HEADER);
+    h[0] = 'B';
+    h[1] = 'M';
+    for (i = 0; i < 6; i++)
+    {
+        h[2 + 4 * i] = fields[i];
+        h[3 + 4 * i] = fields[i] >> 8;
+        h[4 + 4 * i] = fields[i] >> 16;
+        h[5 + 4 * i] = fields[i] >> 24;
+    }
+    h[26] = 1;                      // Planes
+    h[28] = as->pixel_bytes * 8;    // Bits per pixel; compression stays BI_RGB
+    if (image <= 0xFFFFFFFFLL)
+    {
+        h[34] = image;
+        h[35] = image >> 8;
+        h[36] = image >> 16;
+        h[37] = image >> 24;
+    }
+    h[38] = h[42] = 0x13;           // 2835 pixels per metre, 72 dpi
+    h[39] = h[43] = 0x0B;
+}
+
+// Native offset of a view row
+static long long row_offset(const AdapterStream *as, long long row)
+{
+    return as->native_head + (as->flip ? as->height - 1 - row : row) * as->row_bytes;
+}
+
+// Move len row bytes from byte c on between the view and the native pixels, which start at the pixel holding c
+static void convert(const AdapterStream *as, unsigned char *native, unsigned char *view, long long c, long long len, int to_view)
+{
+    long long base = c - c % as->pixel_bytes, j;
+
+    if (!as->swap)
+    {
+        memcpy(to_view ? view : native + c - base, to_view ? native + c - base : view, len);
+    }
+    else if (c == base && len % 3 == 0)
+    {
+        // Whole R, G, B pixels: the view's B, G, R is the same three bytes reversed
+        for (j = 0; j < len; j += 3)
+        {
+            unsigned char *from = to_view ? native + j : view + j, *to = to_view ? view + j : native + j;
+            unsigned char first = from[0];
+            to[1] = from[1];
+            to[0] = from[2];
+            to[2] = first;
+        }
+    }
+    else
+    {
+        for (j = c; j < c + len; j++)
+        {
+            long long at = j - base + 2 - 2 * (j % 3);
+            if (to_view)
+            {
+                view[j - c] = native[at];
+            }
+            else
+            {
+                native[at] = view[j - c];
+            }
+        }
+    }
+}
+
+// Whole view rows from row on that one call converts, 0 when a row is too long for the buffer
+static long long row_run(const AdapterStream *as, long long row, size_t want)
+{
+    long long rows = want / as->stride;
+
+    if (as->stride > ADAPTER_CHUNK)
+    {
+        return 0;
+    }
+    rows = rows < as->height - row ? rows : as->height - row;
+    return rows < ADAPTER_CHUNK / as->stride ? rows : ADAPTER_CHUNK / as->stride;
+}
+
+// Pixels [*p0, *p1) holding row bytes [c, *end), at most a buffer of them
+static void pixel_span(const AdapterStream *as, long long c, long long *end, long long *p0, long long *p1)
+{
+    *p0 = c / as->pixel_bytes;
+    *p1 = (*end + as->pixel_bytes - 1) / as->pixel_bytes;
+    if ((*p1 - *p0) * as->pixel_bytes > ADAPTER_CHUNK)
+    {
+        *p1 = *p0 + ADAPTER_CHUNK / as->pixel_bytes;
+        *end = *p1 * as->pixel_bytes;
+    }
+}
+
+static ssize_t adapter_read(void *cookie, char *buf, size_t size)
+{
+    AdapterStream *as = cookie;
+    unsigned char *out = (unsigned char *)buf;
+    size_t done = 0;
+    long long n;
+
+    while (done < size && as->pos < as->size)
+    {
+        size_t want = size - done;
+        if (as->pos < ADAPTER_BMP_HEADER)
+        {
+            n = ADAPTER_BMP_HEADER - as->pos;
+            n = n < (long long)want ? n : (long long)want;
+            memcpy(out + done, as->head + as->pos, n);
+        }
+        else if (as->pos < as->pixels_end)
+        {
+            long long rel = as->pos - ADAPTER_BMP_HEADER, row = rel / as->stride, c = rel % as->stride;
+            long long rows = c == 0 ? row_run(as, row, want) : 0, i;
+            if (c >= as->row_bytes)
+            {
+                // Row padding
+                n = as->stride - c < (long long)want ? as->stride - c : (long long)want;
+                memset(out + done, 0, n);
+            }
+            else if (rows > 0)
+            {
+                // The native rows of a run are contiguous, in reverse order when flipped
+                long long first = as->flip ? row + rows - 1 : row;
+                if (pread(as->fd, as->buffer, rows * as->row_bytes, row_offset(as, first)) != rows * as->row_bytes)
+                {
+                    return done > 0 ? (ssize_t)done : -1;
+                }
+                for (i = 0; i < rows; i++)
+                {
+                    unsigned char *view = out + done + i * as->stride;
+                    convert(as, as->buffer + (as->flip ? rows - 1 - i : i) * as->row_bytes, view, 0, as->row_bytes, 1);
+                    memset(view + as->row_bytes, 0, as->stride - as->row_bytes);
+                }
+                n = rows * as->stride;
+            }
+            else
+            {
+                long long end = as->row_bytes < c + (long long)want ? as->row_bytes : c + (long long)want, p0, p1;
+                pixel_span(as, c, &end, &p0, &p1);
+                n = (p1 - p0) * as->pixel_bytes;
+                if (pread(as->fd, as->buffer, n, row_offset(as, row) + p0 * as->pixel_bytes) != n)
+                {
+                    return done > 0 ? (ssize_t)done : -1;
+                }
+                convert(as, as->buffer, out + done, c, end - c, 1);
+                n = end - c;
+            }
+        }
+        else
+        {
+            // Whatever follows the pixels is passed through
+            n = as->size - as->pos < (long long)want ? as->size - as->pos : (long long)want;
+            n = pread(as->fd, out + done, n, as->native_head + as->row_bytes * as->height + as->pos - as->pixels_end);
+            if (n <= 0)
+            {
+                return done > 0 ? (ssize_t)done : -1;
+            }
+        }
+        done += n;
+        as->pos += n;
+    }
+    return done;
+}
+
+static ssize_t adapter_write(void *cookie, const char *buf, size_t size)
+{
+    AdapterStream *as = cookie;
+    unsigned char *in = (unsigned char *)buf;
+    size_t done = 0;
+    long long n;
+
+    while (done < size)
+    {
+        size_t want = size - done;
+        if (as->pos < ADAPTER_BMP_HEADER)
+        {
+            // The native header was written when the stream was opened
+            n = ADAPTER_BMP_HEADER - as->pos;
+            n = n < (long long)want ? n : (long long)want;
+        }
+        else if (as->pos < as->pixels_end)
+        {
+            long long rel = as->pos - ADAPTER_BMP_HEADER, row = rel / as->stride, c = rel % as->stride;
+            long long rows = c == 0 ? row_run(as, row, want) : 0, i;
+            if (rows > 0)
+            {
+                long long first = as->flip ? row + rows - 1 : row;
+                for (i = 0; i < rows; i++)
+                {
+                    convert(as, as->buffer + (as->flip ? rows - 1 - i : i) * as->row_bytes, in + done + i * as->stride, 0, as->row_bytes, 0);
+                }
+                if (pwrite(as->fd, as->buffer, rows * as->row_bytes, row_offset(as, first)) != rows * as->row_bytes)
+                {
+                    return done > 0 ? (ssize_t)done : -1;
+                }
+                n = rows * as->stride;
+            }
+            else
+            {
+                long long end = as->row_bytes < c + (long long)want ? as->row_bytes : c + (long long)want, p0, p1, got;
+                pixel_span(as, c, &end, &p0, &p1);
+                n = (p1 - p0) * as->pixel_bytes;
+                // A split pixel keeps the bytes this write does not cover
+                if (c % as->pixel_bytes != 0 || end % as->pixel_bytes != 0)
+                {
+                    got = pread(as->fd, as->buffer, n, row_offset(as, row) + p0 * as->pixel_bytes);
+                    memset(as->buffer + (got > 0 ? got : 0), 0, n - (got > 0 ? got : 0));
+                }
+                convert(as, as->buffer, in + done, c, end - c, 0);
+                if (pwrite(as->fd, as->buffer, n, row_offset(as, row) + p0 * as->pixel_bytes) != n)
+                {
+                    return done > 0 ? (ssize_t)done : -1;
+                }
+                n = end - c;
+            }
+        }
+        else
+        {
+            n = pwrite(as->fd, in + done, want, as->native_head + as->row_bytes * as->height + as->pos - as->pixels_end);
+            if (n <= 0)
+            {
+                return done > 0 ? (ssize_t)done : -1;
+            }
+        }
+        done += n;
+        as->pos += n;
+        as->size = as->pos > as->size ? as->pos : as->size;
+    }
+    return done;
+}
+
+static int adapter_seek(void *cookie, off64_t *offset, int whence)
+{
+    AdapterStream *as = cookie;
+    long long pos = whence == SEEK_SET ? *offset : whence == SEEK_CUR ? as->pos + *offset : as->size + *offset;
+    if (pos < 0)
+    {
+        return -1;
+    }
+    as->pos = pos;
+    *offset = pos;
+    return 0;
+}
+
+static int adapter_close(void *cookie)
+{
+    AdapterStream *as = cookie;
+    int status = as->fd >= 0 ? close(as->fd) : 0;
+    arena_free(as->buffer);
+    free(as);
+    return status;
+}
+
+// Stream with its buffer, reading fname's layout; fd is the stream's
+static AdapterStream *new_stream(int fd, const char *fname, ImageFormat format, uint raw_width, uint raw_height, int padded)
+{
+    AdapterStream *as = calloc(1, sizeof(AdapterStream));
+
+    if (as == NULL)
+    {
+        close(fd);
+        return NULL;
+    }
+    as->fd = fd;
+    as->buffer = arena_alloc(ADAPTER_CHUNK);
+    if (as->buffer == NULL || read_layout(as, fname, format, raw_width, raw_height, padded) == e_failure)
+    {
+        // For the caller's perror; the reason was printed
+        int error = as->buffer == NULL ? ENOMEM : EINVAL;
+        adapter_close(as);
+        errno = error;
+        return NULL;
+    }
+    return as;
+}
+
+FILE *adapter_open_read(const char *fname, ImageFormat format, uint raw_width, uint raw_height, int padded)
+{
+    cookie_io_functions_t io = {adapter_read, NULL, adapter_seek, adapter_close};
+    int fd = open(fname, O_RDONLY | O_CLOEXEC);
+    AdapterStream *as;
+    struct stat st;
+    FILE *fptr;
+
+    if (fd < 0 || fstat(fd, &st) != 0)
+    {
+        perror(fname);
+        if (fd >= 0)
+        {
+            close(fd);
+        }
+        return NULL;
+    }
+    if ((as = new_stream(fd, fname, format, raw_width, raw_height, padded)) == NULL)
+    {
+        return NULL;
+    }
+    if (st.st_size < as->native_head + as->row_bytes * as->height)
+    {
+        printf("ERROR: ❌ %s is shorter than its %lld x %lld pixels\n", fname, as->width, as->height);
+        adapter_close(as);
+        errno = EINVAL;
+        return NULL;
+    }
+    as->size = as->pixels_end + st.st_size - as->native_head - as->row_bytes * as->height;
+    build_head(as);
+    if ((fptr = fopencookie(as, "r", io)) == NULL)
+    {
+        adapter_close(as);
+    }
+    return fptr;
+}
+
+FILE *adapter_open_write(const char *fname, const char *src_fname, ImageFormat format, uint raw_width, uint raw_height)
+{
+    cookie_io_functions_t io = {NULL, adapter_write, adapter_seek, adapter_close};
+    int src_fd = open(src_fname, O_RDONLY | O_CLOEXEC), fd;
+    AdapterStream *as;
+    FILE *fptr;
+
+    if (src_fd < 0)
+    {
+        perror(src_fname);
+        return NULL;
+    }
+    // The layout and header come from the cover; the stream then writes fname
+    if ((as = new_stream(src_fd, src_fname, format, raw_width, raw_height, 0)) == NULL)
+    {
+        return NULL;
+    }
+    fd = open(fname, O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0666);
+    if (fd < 0 || pread(src_fd, as->buffer, as->native_head, 0) != as->native_head ||
+        pwrite(fd, as->buffer, as->native_head, 0) != as->native_head)
+    {
+        perror(fname);
+        if (fd >= 0)
+        {
+            close(fd);
+        }
+        adapter_close(as);
+        return NULL;
+    }
+    close(src_fd);
+    as->fd = fd;
+    if ((fptr = fopencookie(as, "w", io)) == NULL)
+    {
+        adapter_close(as);
+    }
+    return fptr;
+}
@@ -0,0 +1,52 @@
+#ifndef ADAPTER_H
+#define ADAPTER_H
+
+#include <stdio.h>
+#include "types.h" // User-defined data types
+
+/*
+ * Cover adapters: PPM (P6), uncompressed true-colour TGA and raw RGB
+ * frames are read as if they were BMP files, with no conversion pass.
+ * The adapter shows the image as a BMP: a synthesized 54-byte header,
+ * then bottom-up rows of B, G, R (and A for 32 bpp TGA), then whatever
+ * the file holds after its pixels. Every encode and decode step runs on
+ * that view unchanged.
+ * Payload bits go into row padding too, so the view has it only when the
+ * stego image is a BMP; it then matches the converted BMP byte for byte.
+ * When the stego image keeps the cover's format, rows are not padded and
+ * the write adapter maps each view byte back to its pixel byte under the
+ * cover's own header; the decoder reads that image through the same
+ * unpadded view. Each call converts up to ADAPTER_CHUNK native bytes with
+ * one pread or pwrite.
+ *
+ * The streams have no file descriptor, so modes that map the image or
+ * pread it by descriptor (--adaptive, --channels, the recovery scan) do
+ * not take adapted covers, and --resume needs a BMP output.
+ */
+
+#define ADAPTER_CHUNK (1 << 20)   // Native bytes converted per call
+#define ADAPTER_MAX_HEADER 4096   // Longest native header read (PPM comments, TGA image ID)
+#define ADAPTER_BMP_HEADER 54
+
+typedef enum
+{
+    e_format_bmp,
+    e_format_ppm,  // Binary PPM (P6), maxval up to 255
+    e_format_tga,  // Uncompressed true colour TGA, 24 or 32 bpp
+    e_format_raw,  // Raw R, G, B frames, top row first; the size is given with --raw-size
+    e_format_unknown
+} ImageFormat;
+
+/* Format of an image by its extension: .bmp, .ppm, .tga, .rgb or .raw */
+ImageFormat image_format(const char *fname);
+
+/* Parse "<width>x<height>" */
+Status parse_raw_size(const char *arg, uint *width, uint *height);
+
+/* Open a PPM, TGA or raw RGB image read-only as its BMP view, with padded rows for a BMP output */
+FILE *adapter_open_read(const char *fname, ImageFormat format, uint raw_width, uint raw_height, int padded);
+
+/* Create fname in the format and with the header of src_fname; unpadded view bytes written to it land in that format */
+FILE *adapter_open_write(const char *fname, const char *src_fname, ImageFormat format, uint raw_width, uint raw_height);
+
+#endif
@@ -0,0 +1,438 @@
+/*
+Documentation
+Name       :G Gangadhar
+Date       :30/07/2025
+Description:Steganography project
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+#include "adaptive.h"
+#include "arena.h"
+#include "checksum.h"
+#include "common.h"
+#include "decode.h"
+#include "encode.h"
+#include "profile.h"
+#include "types.h"
+
+/* One thread's share of the rows */
+typedef struct _SobelJob
+{
+    TextureMap *map;
+    const unsigned char *pixels; // image + map->base
+    long long stride;            // Bytes per row, padding included
+    long long row_bytes;         // Pixel bytes per row
+    int step;                    // Bytes per pixel: neighbours of the same channel
+    long long rows;
+    long long y0, y1;
+    unsigned long long hist[256];
+} SobelJob;
+
+static inline uint read_le32(const unsigned char *p)
+{
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint)p[3] << 24);
+}
+
+// Sobel magnitude of the upper 7 bits around c, scaled to fit a byte
+static inline unsigned char sobel_score(const unsigned char *c, long long stride, int s)
+{
+    const unsigned char *u = c - stride, *d = c + stride;
+    int gx = ((u[s] >> 1) + 2 * (c[s] >> 1) + (d[s] >> 1)) - ((u[-s] >> 1) + 2 * (c[-s] >> 1) + (d[-s] >> 1));
+    int gy = ((d[-s] >> 1) + 2 * (d[0] >> 1) + (d[s] >> 1)) - ((u[-s] >> 1) + 2 * (u[0] >> 1) + (u[s] >> 1));
+    return ((gx < 0 ? -gx : gx) + (gy < 0 ? -gy : gy)) >> 2;
+}
+
+#ifdef __SSE2__
+// Widen 8 bytes to 16-bit lanes holding their upper 7 bits
+static inline __m128i msb16(__m128i v, int hi)
+{
+    __m128i zero = _mm_setzero_si128();
+    return _mm_srli_epi16(hi ? _mm_unpackhi_epi8(v, zero) : _mm_unpacklo_epi8(v, zero), 1);
+}
+
+static inline __m128i abs16(__m128i v)
+{
+    return _mm_max_epi16(v, _mm_sub_epi16(_mm_setzero_si128(), v));
+}
+
+// sobel_score for 8 lanes
+static inline __m128i sobel8(const __m128i *n, int hi)
+{
+    __m128i ul = msb16(n[0], hi), u = msb16(n[1], hi), ur = msb16(n[2], hi);
+    __m128i l = msb16(n[3], hi), r = msb16(n[4], hi);
+    __m128i dl = msb16(n[5], hi), d = msb16(n[6], hi), dr = msb16(n[7], hi);
+    __m128i gx = _mm_sub_epi16(_mm_add_epi16(_mm_add_epi16(ur, dr), _mm_slli_epi16(r, 1)),
+                               _mm_add_epi16(_mm_add_epi16(ul, dl), _mm_slli_epi16(l, 1)));
+    __m128i gy = _mm_sub_epi16(_mm_add_epi16(_mm_add_epi16(dl, dr), _mm_slli_epi16(d, 1)),
+                               _mm_add_epi16(_mm_add_epi16(ul, ur), _mm_slli_epi16(u, 1)));
+    return _mm_srli_epi16(_mm_add_epi16(abs16(gx), abs16(gy)), 2);
+}
+#endif
+
+// Score rows y0..y1; border rows and columns have no full neighbourhood and score 0
+static void *sobel_rows(void *arg)
+{
+    SobelJob *job = arg;
+    TextureMap *map = job->map;
+    long long S = job->stride;
+    int s = job->step;
+    long long y, x;
+
+    for (y = job->y0; y < job->y1; y++)
+    {
+        unsigned char *out = map->score + y * S;
+        const unsigned char *row = job->pixels + y * S;
+        memset(out, 0, S);
+        if (y > 0 && y < job->rows - 1)
+        {
+            x = s;
+#ifdef __SSE2__
+            for (; x + 16 <= job->row_bytes - s; x += 16)
+            {
+                const unsigned char *c = row + x;
+                __m128i n[8];
+                n[0] = _mm_loadu_si128((const __m128i *)(c - S - s));
+                n[1] = _mm_loadu_si128((const __m128i *)(c - S));
+                n[2] = _mm_loadu_si128((const __m128i *)(c - S + s));
+                n[3] = _mm_loadu_si128((const __m128i *)(c - s));
+                n[4] = _mm_loadu_si128((const __m128i *)(c + s));
+                n[5] = _mm_loadu_si128((const __m128i *)(c + S - s));
+                n[6] = _mm_loadu_si128((const __m128i *)(c + S));
+                n[7] = _mm_loadu_si128((const __m128i *)(c + S + s));
+                _mm_storeu_si128((__m128i *)(out + x), _mm_packus_epi16(sobel8(n, 0), sobel8(n, 1)));
+            }
+#endif
+            for (; x < job->row_bytes - s; x++)
+            {
+                out[x] = sobel_score(row + x, S, s);
+            }
+        }
+
+        // Only bytes past the header compete for the payload
+        long long first = map->data_start - map->base - y * S;
+        for (x = first > 0 ? first : 0; x < S; x++)
+        {
+            job->hist[out[x]]++;
+        }
+    }
+    return NULL;
+}
+
+// Geometry from the BMP header, then the rows split across threads
+Status adaptive_build_map(const unsigned char *image, size_t file_len, long long data_start, TextureMap *map)
+{
+    SobelJob jobs[ADAPTIVE_MAX_THREADS];
+    pthread_t threads[ADAPTIVE_MAX_THREADS];
+    int i, started, nthreads = profile_threads(ADAPTIVE_MAX_THREADS);
+
+    memset(map, 0, sizeof(*map));
+    if (file_len < 54)
+    {
+        return e_failure;
+    }
+    int height = (int)read_le32(image + 22);
+    uint width = read_le32(image + 18);
+    int bpp = image[28] | (image[29] << 8);
+    if (bpp != 24 && bpp != 32)
+    {
+        printf("ERROR: ❌ Adaptive embedding needs a 24 or 32 bpp image, not %d bpp\n", bpp);
+        return e_failure;
+    }
+
+    long long stride = ((long long)width * (bpp / 8) + 3) & ~3LL;
+    long long rows = height < 0 ? -(long long)height : height;
+    map->base = read_le32(image + 10);
+    map->data_start = data_start;
+    if (stride == 0 || map->base >= (long long)file_len)
+    {
+        return e_failure;
+    }
+    if (rows > ((long long)file_len - map->base) / stride)
+    {
+        rows = ((long long)file_len - map->base) / stride;
+    }
+    if (rows < 3)
+    {
+        printf("ERROR: ❌ Image is too small for adaptive embedding\n");
+        return e_failure;
+    }
+    map->len = rows * stride;
+    map->score = arena_alloc(map->len);
+    if (map->score == NULL)
+    {
+        fprintf(stderr, "ERROR: ❌ Out of memory for %lld texture scores\n", map->len);
+        return e_failure;
+    }
+
+    if (nthreads > rows / 16 + 1)
+    {
+        nthreads = rows / 16 + 1;
+    }
+    for (i = 0; i < nthreads; i++)
+    {
+        memset(&jobs[i], 0, sizeof(SobelJob));
+        jobs[i].map = map;
+        jobs[i].pixels = image + map->base;
+        jobs[i].stride = stride;
+        jobs[i].row_bytes = (long long)width * (bpp / 8);
+        jobs[i].step = bpp / 8;
+        jobs[i].rows = rows;
+        jobs[i].y0 = rows * i / nthreads;
+        jobs[i].y1 = rows * (i + 1) / nthreads;
+    }
+    for (started = 1; started < nthreads; started++)
+    {
+        if (pthread_create(&threads[started], NULL, sobel_rows, &jobs[started]) != 0)
+        {
+            break;
+        }
+    }
+    // Shares without a thread run here
+    for (i = started; i < nthreads; i++)
+    {
+        sobel_rows(&jobs[i]);
+    }
+    sobel_rows(&jobs[0]);
+    for (i = 1; i < started; i++)
+    {
+        pthread_join(threads[i], NULL);
+    }
+    for (i = 0; i < nthreads; i++)
+    {
+        int b;
+        for (b = 0; b < 256; b++)
+        {
+            map->hist[b] += jobs[i].hist[b];
+        }
+    }
+    return e_success;
+}
+
+// Walk the histogram down from the most textured score
+Status adaptive_select(TextureMap *map, unsigned long long need)
+{
+    unsigned long long above = 0;
+    int t;
+
+    for (t = 255; t >= 0; t--)
+    {
+        if (above + map->hist[t] >= need)
+        {
+            map->threshold = t;
+            map->ties = need - above;
+            return e_success;
+        }
+        above += map->hist[t];
+    }
+    printf("ERROR: ❌ Only %llu cover bytes available, %llu needed\n", above, need);
+    return e_failure;
+}
+
+void adaptive_free_map(TextureMap *map)
+{
+    arena_free(map->score);
+    map->score = NULL;
+}
+
+// Is the byte at file offset off one of the selected ones? Consumes a tie when it is one
+static inline int adaptive_take(const TextureMap *map, long long off, unsigned long long *ties)
+{
+    long long i = off - map->base;
+    if (i < 0 || i >= map->len || map->score[i] < map->threshold)
+    {
+        return 0;
+    }
+    if (map->score[i] > map->threshold)
+    {
+        return 1;
+    }
+    if (*ties > 0)
+    {
+        (*ties)--;
+        return 1;
+    }
+    return 0;
+}
+
+// Map a whole file read-only, or read it when it cannot be mapped
+static unsigned char *load_image(FILE *fptr, size_t *len, int *mapped)
+{
+    struct stat st;
+    unsigned char *data;
+
+    fflush(fptr);
+    if (fstat(fileno(fptr), &st) != 0 || st.st_size == 0)
+    {
+        return NULL;
+    }
+    *len = st.st_size;
+    *mapped = 1;
+    data = mmap(NULL, *len, PROT_READ, MAP_PRIVATE, fileno(fptr), 0);
+    if (data != MAP_FAILED)
+    {
+        return data;
+    }
+    *mapped = 0;
+    long pos = ftell(fptr);
+    data = malloc(*len);
+    if (data == NULL || fseek(fptr, 0, SEEK_SET) != 0 || fread(data, *len, 1, fptr) != 1)
+    {
+        free(data);
+        return NULL;
+    }
+    fseek(fptr, pos, SEEK_SET);
+    return data;
+}
+
+static void unload_image(unsigned char *data, size_t len, int mapped)
+{
+    if (mapped)
+    {
+        munmap(data, len);
+    }
+    else
+    {
+        free(data);
+    }
+}
+
+// Checksum sequentially after the header, then the data bits into the selected bytes
+Status encode_adaptive_data(EncodeInfo *encInfo)
+{
+    TextureMap map;
+    VerifyInfo *verify = get_verify_info(encInfo);
+    unsigned long long need = (unsigned long long)encInfo->size_secret_file * 8, bit = 0;
+    unsigned char *image = NULL, *buffer = NULL;
+    char *secret = arena_alloc(encInfo->size_secret_file + 1);
+    char got = 0;
+    size_t len = 0;
+    int mapped = 0;
+    Status status = e_failure;
+
+    map.score = NULL;
+    rewind(encInfo->fptr_secret);
+    if (secret == NULL ||
+        (encInfo->size_secret_file > 0 && fread(secret, encInfo->size_secret_file, 1, encInfo->fptr_secret) != 1))
+    {
+        fprintf(stderr, "ERROR: ❌ Failed to read %d bytes from secret file.\n", encInfo->size_secret_file);
+        goto out;
+    }
+    encInfo->secret_crc = crc32_update(0, secret, encInfo->size_secret_file);
+    if (encInfo->verify && encode_secret_file_crc(encInfo) == e_failure)
+    {
+        goto out;
+    }
+
+    long long data_start = ftell(encInfo->fptr_src_image);
+    image = load_image(encInfo->fptr_src_image, &len, &mapped);
+    buffer = arena_alloc(ADAPTIVE_BLOCK_SIZE);
+    if (image == NULL || buffer == NULL || adaptive_build_map(image, len, data_start, &map) == e_failure ||
+        adaptive_select(&map, need) == e_failure)
+    {
+        goto out;
+    }
+    printf("[INFO] Embedding into %llu textured bytes (score >= %d)\n", need, map.threshold);
+
+    unsigned long long ties = map.ties;
+    long long off = data_start;
+    while (off < (long long)len)
+    {
+        size_t n = len - off < ADAPTIVE_BLOCK_SIZE ? len - off : ADAPTIVE_BLOCK_SIZE;
+        size_t j;
+        memcpy(buffer, image + off, n);
+        for (j = 0; j < n && bit < need; j++)
+        {
+            if (adaptive_take(&map, off + j, &ties))
+            {
+                buffer[j] = (buffer[j] & 0xFE) | ((secret[bit >> 3] >> (7 - (bit & 7))) & 1);
+                got = (got << 1) | (buffer[j] & 1);
+                if ((++bit & 7) == 0 && verify != NULL)
+                {
+                    verify_window(verify, &secret[(bit >> 3) - 1], &got, 1);
+                }
+            }
+        }
+        if (fwrite(buffer, n, 1, encInfo->fptr_stego_image) != 1)
+        {
+            fprintf(stderr, "ERROR: ❌ Failed to write encoded data to destination image\n");
+            goto out;
+        }
+        off += n;
+    }
+    status = bit == need ? e_success : e_failure;
+
+out:
+    adaptive_free_map(&map);
+    if (image != NULL)
+    {
+        unload_image(image, len, mapped);
+    }
+    arena_free(buffer);
+    arena_free(secret);
+    return status;
+}
+
+// Rebuild the same texture map from the stego image and collect the selected LSBs
+Status decode_adaptive_data(DecodeInfo *decInfo)
+{
+    TextureMap map;
+    unsigned long long need = (unsigned long long)decInfo->size_secret_file * 8, bit = 0;
+    unsigned char *image, *buffer = arena_alloc(ADAPTIVE_BLOCK_SIZE);
+    size_t len = 0, fill = 0;
+    int mapped = 0;
+    uint acc = 0;
+    Status status = e_failure;
+
+    map.score = NULL;
+    decInfo->secret_crc = 0;
+    long long data_start = ftell(decInfo->fptr_stego_image) + ((decInfo->stego_flags & FLAG_CRC) ? 32 : 0);
+    image = load_image(decInfo->fptr_stego_image, &len, &mapped);
+    if (image == NULL || buffer == NULL || adaptive_build_map(image, len, data_start, &map) == e_failure ||
+        adaptive_select(&map, need) == e_failure)
+    {
+        goto out;
+    }
+
+    unsigned long long ties = map.ties;
+    long long off;
+    for (off = data_start; off < (long long)len && bit < need; off++)
+    {
+        if (!adaptive_take(&map, off, &ties))
+        {
+            continue;
+        }
+        acc = (acc << 1) | (image[off] & 1);
+        if ((++bit & 7) == 0)
+        {
+            buffer[fill++] = acc & 0xFF;
+            if (fill == ADAPTIVE_BLOCK_SIZE || bit == need)
+            {
+                decInfo->secret_crc = crc32_update(decInfo->secret_crc, (char *)buffer, fill);
+                if (fwrite(buffer, fill, 1, decInfo->fptr_secret) != 1)
+                {
+                    printf("ERROR: ❌ Failed to write %s into %s decoding data\n", decInfo->stego_image_fname, decInfo->secret_fname);
+                    goto out;
+                }
+                fill = 0;
+            }
+        }
+    }
+    status = bit == need ? e_success : e_failure;
+
+out:
+    adaptive_free_map(&map);
+    if (image != NULL)
+    {
+        unload_image(image, len, mapped);
+    }
+    arena_free(buffer);
+    return status;
+}
@@ -0,0 +1,51 @@
+#ifndef ADAPTIVE_H
+#define ADAPTIVE_H
+
+#include <stddef.h>
+#include "decode.h" // DecodeInfo
+#include "encode.h" // EncodeInfo
+#include "types.h"  // User-defined data types
+
+/*
+ * Edge-adaptive embedding: the secret data goes only into the most
+ * textured cover bytes instead of the first ones in the file.
+ * Texture is a Sobel gradient over the upper 7 bits of each byte, against
+ * the neighbouring bytes of the same colour channel, so embedding never
+ * changes it and the decoder finds the same bytes again. The header (and
+ * checksum) stay sequential right after byte 54.
+ *
+ * Selection: every byte after the header whose score is above a threshold
+ * T, plus the first bytes scoring exactly T in file order, where T is the
+ * highest score that still yields enough bytes.
+ */
+
+#define ADAPTIVE_MAX_THREADS 16
+#define ADAPTIVE_BLOCK_SIZE (1 << 20)
+
+typedef struct _TextureMap
+{
+    unsigned char *score;         // One score per byte from base on
+    long long base;               // File offset of score[0] (the pixel array)
+    long long len;                // Bytes covered by score
+    long long data_start;         // First byte that may carry data
+    unsigned long long hist[256]; // Scores of the bytes from data_start on
+    int threshold;                // Bytes above this score are taken ...
+    unsigned long long ties;      // ... plus this many scoring exactly threshold
+} TextureMap;
+
+/* Score the pixel array of a mapped BMP image on a few threads */
+Status adaptive_build_map(const unsigned char *image, size_t file_len, long long data_start, TextureMap *map);
+
+/* Pick the threshold that selects exactly need bytes */
+Status adaptive_select(TextureMap *map, unsigned long long need);
+
+/* Release the score array */
+void adaptive_free_map(TextureMap *map);
+
+/* Encode the secret data into the selected bytes and copy the rest of the image */
+Status encode_adaptive_data(EncodeInfo *encInfo);
+
+/* Decode the secret data from the selected bytes; the file position is left as it was */
+Status decode_adaptive_data(DecodeInfo *decInfo);
+
+#endif
@@ -0,0 +1,320 @@
+/*
+Documentation
+Name       :G Gangadhar
+Date       :30/07/2025
+Description:Steganography project
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include "arena.h"
+#include "types.h"
+
+#define ARENA_HEADER 64 // Block header ahead of the buffer; keeps buffers 64-byte aligned
+
+enum
+{
+    e_huge_off,
+    e_huge_thp,
+    e_huge_auto
+};
+
+typedef struct _ArenaBlock
+{
+    struct _Arena *owner;
+    struct _ArenaBlock *next; // Free list link
+    size_t mapped;            // Bytes mapped, header included
+    int cls;                  // Size class
+    int huge;                 // On MAP_HUGETLB pages
+} ArenaBlock;
+
+typedef struct _Arena
+{
+    pthread_mutex_t lock;
+    ArenaBlock *free[ARENA_CLASSES];
+    size_t in_use;               // Bytes handed out
+    size_t peak;
+    size_t mapped;               // Bytes mapped, free or handed out
+    size_t cached;               // Bytes on the free lists
+    size_t steady;               // mapped at the end of the last job
+    unsigned long long maps, huge, reuses, jobs, warm_maps;
+    int retired;                 // Its thread has exited; released buffers are unmapped
+    struct _Arena *next;         // Registry link
+} Arena;
+
+static pthread_once_t arena_once = PTHREAD_ONCE_INIT;
+static pthread_key_t arena_key;
+static pthread_mutex_t registry_lock = PTHREAD_MUTEX_INITIALIZER;
+static Arena *registry;
+static int huge_mode;
+static __thread Arena *thread_arena;
+
+// A thread's free buffers go back to the system when it exits; the arena stays for the figures
+static void retire_arena(void *arg)
+{
+    Arena *arena = arg;
+    ArenaBlock *unmap = NULL;
+    int i;
+
+    pthread_mutex_lock(&arena->lock);
+    arena->retired = 1;
+    for (i = 0; i < ARENA_CLASSES; i++)
+    {
+        while (arena->free[i] != NULL)
+        {
+            ArenaBlock *block = arena->free[i];
+            arena->free[i] = block->next;
+            block->next = unmap;
+            unmap = block;
+        }
+    }
+    arena->mapped -= arena->cached;
+    arena->cached = 0;
+    pthread_mutex_unlock(&arena->lock);
+
+    while (unmap != NULL)
+    {
+        ArenaBlock *next = unmap->next;
+        munmap(unmap, unmap->mapped);
+        unmap = next;
+    }
+}
+
+static void arena_init(void)
+{
+    const char *env = getenv(ARENA_ENV_HUGE);
+
+    pthread_key_create(&arena_key, retire_arena);
+    huge_mode = e_huge_auto;
+    if (env != NULL && strcmp(env, "0") == 0)
+    {
+        huge_mode = e_huge_off;
+    }
+    else if (env != NULL && strcmp(env, "thp") == 0)
+    {
+        huge_mode = e_huge_thp;
+    }
+}
+
+// The calling thread's arena, created on first use
+static Arena *get_arena(void)
+{
+    Arena *arena = thread_arena;
+
+    if (arena != NULL)
+    {
+        return arena;
+    }
+    pthread_once(&arena_once, arena_init);
+    arena = calloc(1, sizeof(Arena));
+    if (arena == NULL)
+    {
+        return NULL;
+    }
+    pthread_mutex_init(&arena->lock, NULL);
+    pthread_mutex_lock(&registry_lock);
+    arena->next = registry;
+    registry = arena;
+    pthread_mutex_unlock(&registry_lock);
+    pthread_setspecific(arena_key, arena);
+    thread_arena = arena;
+    return arena;
+}
+
+// Bytes of a class: 2^n, then 1.25, 1.5 and 1.75 times that
+static size_t class_size(int cls)
+{
+    int shift = ARENA_MIN_SHIFT + cls / 4;
+    return ((size_t)1 << shift) + (size_t)(cls % 4) * ((size_t)1 << (shift - 2));
+}
+
+// Smallest class holding size bytes after the header, -1 if none does
+static int size_class(size_t size)
+{
+    int cls;
+    for (cls = 0; cls < ARENA_CLASSES; cls++)
+    {
+        if (size + ARENA_HEADER <= class_size(cls))
+        {
+            return cls;
+        }
+    }
+    return -1;
+}
+
+// Map a block of one class: explicit huge pages, else plain pages aligned for transparent ones
+static ArenaBlock *map_block(int cls)
+{
+    size_t len = class_size(cls);
+    int want_huge = len >= ARENA_HUGE_PAGE && huge_mode != e_huge_off;
+    ArenaBlock *block = NULL;
+    char *p;
+
+#ifdef MAP_HUGETLB
+    if (want_huge && huge_mode == e_huge_auto)
+    {
+        // Explicit huge page mappings come in whole pages
+        size_t huge_len = (len + ARENA_HUGE_PAGE - 1) / ARENA_HUGE_PAGE * ARENA_HUGE_PAGE;
+        p = mmap(NULL, huge_len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (p != MAP_FAILED)
+        {
+            block = (ArenaBlock *)p;
+            block->huge = 1;
+            len = huge_len;
+        }
+    }
+#endif
+    if (block == NULL)
+    {
+        // Over-map by a huge page and trim, so the block starts on a huge page boundary
+        size_t extra = want_huge ? ARENA_HUGE_PAGE : 0;
+        p = mmap(NULL, len + extra, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (p == MAP_FAILED)
+        {
+            return NULL;
+        }
+        if (extra)
+        {
+            size_t head = (ARENA_HUGE_PAGE - (uintptr_t)p % ARENA_HUGE_PAGE) % ARENA_HUGE_PAGE;
+            if (head)
+            {
+                munmap(p, head);
+            }
+            munmap(p + head + len, extra - head);
+            p += head;
+#ifdef MADV_HUGEPAGE
+            madvise(p, len, MADV_HUGEPAGE);
+#endif
+        }
+        block = (ArenaBlock *)p;
+        block->huge = 0;
+    }
+    block->mapped = len;
+    block->cls = cls;
+    return block;
+}
+
+void *arena_alloc(size_t size)
+{
+    Arena *arena = get_arena();
+    int cls = size_class(size);
+    ArenaBlock *block;
+
+    if (arena == NULL || cls < 0)
+    {
+        return NULL;
+    }
+    pthread_mutex_lock(&arena->lock);
+    block = arena->free[cls];
+    if (block != NULL)
+    {
+        arena->free[cls] = block->next;
+        arena->cached -= block->mapped;
+        arena->reuses++;
+    }
+    pthread_mutex_unlock(&arena->lock);
+
+    if (block == NULL && (block = map_block(cls)) == NULL)
+    {
+        return NULL;
+    }
+    pthread_mutex_lock(&arena->lock);
+    if (block->owner == NULL)
+    {
+        block->owner = arena;
+        arena->mapped += block->mapped;
+        arena->maps++;
+        arena->huge += block->huge;
+    }
+    arena->in_use += block->mapped;
+    if (arena->in_use > arena->peak)
+    {
+        arena->peak = arena->in_use;
+    }
+    pthread_mutex_unlock(&arena->lock);
+    return (char *)block + ARENA_HEADER;
+}
+
+void arena_free(void *ptr)
+{
+    ArenaBlock *block;
+    Arena *arena;
+    int keep;
+
+    if (ptr == NULL)
+    {
+        return;
+    }
+    block = (ArenaBlock *)((char *)ptr - ARENA_HEADER);
+    arena = block->owner;
+    pthread_mutex_lock(&arena->lock);
+    arena->in_use -= block->mapped;
+    keep = !arena->retired && arena->cached + block->mapped <= (size_t)ARENA_MAX_CACHED_MB << 20;
+    if (keep)
+    {
+        block->next = arena->free[block->cls];
+        arena->free[block->cls] = block;
+        arena->cached += block->mapped;
+    }
+    else
+    {
+        arena->mapped -= block->mapped;
+    }
+    pthread_mutex_unlock(&arena->lock);
+    if (!keep)
+    {
+        munmap(block, block->mapped);
+    }
+}
+
+void arena_job_done(void)
+{
+    Arena *arena = get_arena();
+
+    if (arena == NULL)
+    {
+        return;
+    }
+    pthread_mutex_lock(&arena->lock);
+    if (arena->jobs++ == 0)
+    {
+        arena->warm_maps = arena->maps;
+    }
+    arena->steady = arena->mapped;
+    pthread_mutex_unlock(&arena->lock);
+}
+
+void arena_stats(ArenaStats *stats)
+{
+    Arena *arena;
+
+    memset(stats, 0, sizeof(*stats));
+    pthread_mutex_lock(&registry_lock);
+    for (arena = registry; arena != NULL; arena = arena->next)
+    {
+        pthread_mutex_lock(&arena->lock);
+        stats->in_use += arena->in_use;
+        stats->peak += arena->peak;
+        stats->steady += arena->jobs ? arena->steady : arena->mapped;
+        stats->maps += arena->maps;
+        stats->huge += arena->huge;
+        stats->reuses += arena->reuses;
+        stats->jobs += arena->jobs;
+        stats->warm_maps += arena->jobs ? arena->maps - arena->warm_maps : 0;
+        pthread_mutex_unlock(&arena->lock);
+    }
+    pthread_mutex_unlock(&registry_lock);
+}
+
+void arena_report(void)
+{
+    ArenaStats stats;
+
+    arena_stats(&stats);
+    printf("[INFO] Buffer arena: peak %zu KB in use, %zu KB mapped in steady state, %llu buffers mapped "
+           "(%llu on huge pages), %llu reused, %llu mapped after the first job over %llu jobs\n",
+           stats.peak >> 10, stats.steady >> 10, stats.maps, stats.huge, stats.reuses, stats.warm_maps, stats.jobs);
+}
@@ -0,0 +1,53 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stddef.h>
+#include "types.h" // User-defined data types
+
+/*
+ * Per-thread buffer arena for the job hot paths: pipeline blocks, secret
+ * buffers, scan windows, lane rows, texture maps and the stdio buffers of
+ * the image files. Buffers are mapped once per size class and kept on
+ * the thread's free lists when released, so the second and later jobs of
+ * a worker map nothing. Classes step by a quarter of a power of two, so a
+ * buffer wastes at most a fifth of its class. Classes of 2 MB and up are
+ * backed by huge pages: explicit ones (MAP_HUGETLB) when the pool has
+ * some, else transparent ones through madvise on a 2 MB aligned mapping.
+ * A buffer may be released on any thread; it goes back to its own arena.
+ */
+
+#define ARENA_ENV_HUGE "STEGO_HUGEPAGES" // "0" maps plain pages only, "thp" skips MAP_HUGETLB
+#define ARENA_MIN_SHIFT 16               // Smallest class: 64 KB
+#define ARENA_CLASSES 160                // Four per power of two, up to 2^56 bytes
+#define ARENA_HUGE_PAGE (2UL << 20)
+#define ARENA_MAX_CACHED_MB 1024         // Free bytes an arena keeps before unmapping
+#define ARENA_STDIO_BUF (64 << 10)       // stdio buffer of an image FILE
+
+typedef struct _ArenaStats
+{
+    size_t in_use;               // Bytes handed out now
+    size_t peak;                 // Most bytes handed out at once
+    size_t steady;               // Bytes mapped when each arena finished its last job
+    unsigned long long maps;     // Buffers mapped
+    unsigned long long huge;     // ... of them on huge pages
+    unsigned long long reuses;   // Requests served from a free list
+    unsigned long long jobs;     // Jobs marked with arena_job_done
+    unsigned long long warm_maps; // Buffers mapped after each arena's first job
+} ArenaStats;
+
+/* Buffer of at least size bytes, 64-byte aligned, from the calling thread's arena */
+void *arena_alloc(size_t size);
+
+/* Return a buffer to the arena it came from; NULL is ignored */
+void arena_free(void *ptr);
+
+/* Mark the end of a job on the calling thread, for the steady-state figures */
+void arena_job_done(void);
+
+/* Totals over every arena of the process */
+void arena_stats(ArenaStats *stats);
+
+/* Print the totals */
+void arena_report(void);
+
+#endif
@@ -0,0 +1,383 @@
+/*
+Documentation
+Name       :G Gangadhar
+Date       :30/07/2025
+Description:Steganography project
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
+#include "arena.h"
+#include "async.h"
+#include "decode.h"
+#include "encode.h"
+#include "journal.h"
+#include "profile.h"
+#include "update.h"
+#include "types.h"
+
+// Milliseconds on the monotonic clock
+static long long now_ms(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000LL + ts.tv_nsec / 1000000;
+}
+
+// Cancelled, or past the deadline
+int job_control_should_stop(JobControl *control)
+{
+    if (control == NULL)
+    {
+        return 0;
+    }
+    return atomic_load(&control->cancel) || (control->deadline_ms != 0 && now_ms() >= control->deadline_ms);
+}
+
+// Fresh control block, no deadline
+static void job_control_init(JobControl *control)
+{
+    atomic_init(&control->cancel, 0);
+    control->deadline_ms = 0;
+    atomic_init(&control->done, 0);
+    atomic_init(&control->total, 0);
+}
+
+// Build an argv like the CLI's: a.out <op> [options...] args...
+static int build_argv(char *argv[], char *op, char *options[], char *a, char *b, char *c)
+{
+    int argc = 0, i;
+    argv[argc++] = "a.out";
+    argv[argc++] = op;
+    for (i = 0; options != NULL && options[i] != NULL && i < JOB_MAX_OPTIONS; i++)
+    {
+        argv[argc++] = options[i];
+    }
+    argv[argc++] = a;
+    if (b != NULL)
+    {
+        argv[argc++] = b;
+        if (c != NULL)
+        {
+            argv[argc++] = c;
+        }
+    }
+    argv[argc] = NULL;
+    return argc;
+}
+
+// Validate an encode job the same way the command line does
+Status job_init_encode(StegoJob *job, char *src_image, char *secret, char *stego_image, char *options[])
+{
+    char *argv[JOB_MAX_OPTIONS + 8];
+    int argc = build_argv(argv, "-e", options, src_image, secret, stego_image);
+
+    memset(job, 0, sizeof(*job));
+    job->op = e_encode;
+    job_control_init(&job->control);
+    if (read_encode_options(&argc, argv, &job->enc) == e_failure || argc < 4 ||
+        read_and_validate_encode_args(argv, &job->enc) == e_failure)
+    {
+        return e_failure;
+    }
+    if (job->enc.adaptive || job->enc.channels || job->enc.update_mode != UPDATE_NONE || job->enc.auto_cover_dir != NULL)
+    {
+        fprintf(stderr, "ERROR: ❌ --adaptive, --channels, --append, --update and --auto-cover cannot run as async jobs\n");
+        return e_failure;
+    }
+    // Cancellation and progress live in the pipeline
+    job->enc.pipeline = 1;
+    job->enc.cache_dir = NULL;
+    job->enc.control = &job->control;
+    return e_success;
+}
+
+// Validate a decode job the same way the command line does
+Status job_init_decode(StegoJob *job, char *stego_image, char *output, char *options[])
+{
+    char *argv[JOB_MAX_OPTIONS + 8];
+    int argc = build_argv(argv, "-d", options, stego_image, output, NULL);
+
+    memset(job, 0, sizeof(*job));
+    job->op = e_decode;
+    job_control_init(&job->control);
+    if (read_decode_options(&argc, argv, &job->dec) == e_failure || argc < 3 ||
+        read_and_validate_decode_args(argv, &job->dec) == e_failure)
+    {
+        return e_failure;
+    }
+    job->dec.pipeline = 1;
+    job->dec.control = &job->control;
+    return e_success;
+}
+
+// Run one job to completion and work out how it ended
+static JobState run_job(StegoJob *job)
+{
+    Status status;
+    int created;
+
+    if (job_control_should_stop(&job->control))
+    {
+        return atomic_load(&job->control.cancel) ? e_job_cancelled : e_job_expired;
+    }
+    if (job->op == e_encode)
+    {
+        status = do_encoding(&job->enc);
+        created = job->enc.fptr_stego_image != NULL && job->enc.update_mode == UPDATE_NONE;
+        close_encode_files(&job->enc);
+        if (status == e_failure && created)
+        {
+            unlink(job->enc.stego_image_fname);
+            if (job->enc.resume)
+            {
+                journal_remove(job->enc.stego_image_fname);
+            }
+        }
+    }
+    else
+    {
+        status = do_decoding(&job->dec);
+        created = job->dec.fptr_secret != NULL;
+        close_decode_files(&job->dec);
+        if (status == e_failure && created)
+        {
+            unlink(job->dec.secret_fname);
+            if (job->dec.resume)
+            {
+                journal_remove(job->dec.secret_fname);
+            }
+        }
+    }
+    arena_job_done();
+
+    if (status == e_success)
+    {
+        atomic_store(&job->control.done, atomic_load(&job->control.total));
+        return e_job_done;
+    }
+    if (atomic_load(&job->control.cancel))
+    {
+        return e_job_cancelled;
+    }
+    return job_control_should_stop(&job->control) ? e_job_expired : e_job_failed;
+}
+
+// Publish the end state; after this the executor no longer touches the job
+static void finish_job(Executor *executor, StegoJob *job, JobState state)
+{
+    uint64_t one = 1;
+
+    pthread_mutex_lock(&executor->lock);
+    job->state = state;
+    if (job->on_done != NULL)
+    {
+        // The callback owns the job from here and may free it
+        pthread_mutex_unlock(&executor->lock);
+        job->on_done(job, state, job->arg);
+        return;
+    }
+    job->next = NULL;
+    if (executor->done_tail != NULL)
+    {
+        executor->done_tail->next = job;
+    }
+    else
+    {
+        executor->done_head = job;
+    }
+    executor->done_tail = job;
+    if (write(executor->done_fd, &one, sizeof(one)) != sizeof(one))
+    {
+        perror("eventfd");
+    }
+    pthread_cond_broadcast(&executor->done_cond);
+    pthread_mutex_unlock(&executor->lock);
+}
+
+// Worker: take queued jobs until shutdown
+static void *executor_worker(void *arg)
+{
+    Executor *executor = arg;
+    while (1)
+    {
+        pthread_mutex_lock(&executor->lock);
+        while (executor->head == NULL && !executor->shutdown)
+        {
+            pthread_cond_wait(&executor->work_cond, &executor->lock);
+        }
+        StegoJob *job = executor->head;
+        if (job == NULL)
+        {
+            pthread_mutex_unlock(&executor->lock);
+            break;
+        }
+        executor->head = job->next;
+        if (executor->head == NULL)
+        {
+            executor->tail = NULL;
+        }
+        job->state = e_job_running;
+        pthread_mutex_unlock(&executor->lock);
+
+        finish_job(executor, job, run_job(job));
+    }
+    return NULL;
+}
+
+// Start the worker threads
+Status executor_init(Executor *executor, int nthreads)
+{
+    int i;
+
+    memset(executor, 0, sizeof(*executor));
+    if (nthreads <= 0)
+    {
+        nthreads = profile_threads(EXECUTOR_MAX_THREADS);
+    }
+    if (nthreads > EXECUTOR_MAX_THREADS)
+    {
+        nthreads = EXECUTOR_MAX_THREADS;
+    }
+    executor->done_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK | EFD_SEMAPHORE);
+    if (executor->done_fd < 0)
+    {
+        perror("eventfd");
+        return e_failure;
+    }
+    pthread_mutex_init(&executor->lock, NULL);
+    pthread_cond_init(&executor->work_cond, NULL);
+    pthread_cond_init(&executor->done_cond, NULL);
+    for (i = 0; i < nthreads; i++)
+    {
+        if (pthread_create(&executor->threads[i], NULL, executor_worker, executor) != 0)
+        {
+            break;
+        }
+    }
+    executor->nthreads = i;
+    if (i == 0)
+    {
+        close(executor->done_fd);
+        return e_failure;
+    }
+    return e_success;
+}
+
+// Queued jobs end as cancelled; running ones finish first
+void executor_shutdown(Executor *executor)
+{
+    StegoJob *queued;
+    int i;
+
+    pthread_mutex_lock(&executor->lock);
+    executor->shutdown = 1;
+    queued = executor->head;
+    executor->head = executor->tail = NULL;
+    pthread_cond_broadcast(&executor->work_cond);
+    pthread_mutex_unlock(&executor->lock);
+
+    while (queued != NULL)
+    {
+        StegoJob *next = queued->next;
+        finish_job(executor, queued, e_job_cancelled);
+        queued = next;
+    }
+    for (i = 0; i < executor->nthreads; i++)
+    {
+        pthread_join(executor->threads[i], NULL);
+    }
+    close(executor->done_fd);
+    arena_report();
+    pthread_mutex_destroy(&executor->lock);
+    pthread_cond_destroy(&executor->work_cond);
+    pthread_cond_destroy(&executor->done_cond);
+}
+
+// Append a job to the queue and wake a worker
+Status executor_submit(Executor *executor, StegoJob *job, void (*on_done)(StegoJob *job, JobState state, void *arg), void *arg, long long timeout_ms)
+{
+    job->executor = executor;
+    job->on_done = on_done;
+    job->arg = arg;
+    job->next = NULL;
+    job->control.deadline_ms = timeout_ms > 0 ? now_ms() + timeout_ms : 0;
+
+    pthread_mutex_lock(&executor->lock);
+    if (executor->shutdown)
+    {
+        pthread_mutex_unlock(&executor->lock);
+        return e_failure;
+    }
+    job->state = e_job_queued;
+    if (executor->tail != NULL)
+    {
+        executor->tail->next = job;
+    }
+    else
+    {
+        executor->head = job;
+    }
+    executor->tail = job;
+    pthread_cond_signal(&executor->work_cond);
+    pthread_mutex_unlock(&executor->lock);
+    return e_success;
+}
+
+// The worker notices at its next check
+void job_cancel(StegoJob *job)
+{
+    atomic_store(&job->control.cancel, 1);
+}
+
+// Sleep until the job reaches an end state
+JobState job_wait(StegoJob *job)
+{
+    Executor *executor = job->executor;
+    JobState state;
+
+    pthread_mutex_lock(&executor->lock);
+    while (job->state == e_job_queued || job->state == e_job_running)
+    {
+        pthread_cond_wait(&executor->done_cond, &executor->lock);
+    }
+    state = job->state;
+    pthread_mutex_unlock(&executor->lock);
+    return state;
+}
+
+// Snapshot of the job's counters
+void job_progress(StegoJob *job, unsigned long long *done, unsigned long long *total)
+{
+    *done = atomic_load(&job->control.done);
+    *total = atomic_load(&job->control.total);
+}
+
+// Pop a finished job and consume its eventfd count
+StegoJob *executor_reap(Executor *executor)
+{
+    StegoJob *job;
+    uint64_t count;
+
+    pthread_mutex_lock(&executor->lock);
+    job = executor->done_head;
+    if (job != NULL)
+    {
+        executor->done_head = job->next;
+        if (executor->done_head == NULL)
+        {
+            executor->done_tail = NULL;
+        }
+        // Semaphore mode: each read takes one, so the fd stays readable while more are waiting
+        if (read(executor->done_fd, &count, sizeof(count)) != sizeof(count))
+        {
+            perror("eventfd");
+        }
+    }
+    pthread_mutex_unlock(&executor->lock);
+    return job;
+}
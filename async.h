@@ -0,0 +1,101 @@
+#ifndef ASYNC_H
+#define ASYNC_H
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include "decode.h" // DecodeInfo
+#include "encode.h" // EncodeInfo
+#include "types.h"  // User-defined data types
+
+/*
+ * Asynchronous encode/decode for event-loop services.
+ * Jobs are queued on an executor with a few worker threads and run
+ * through the pipeline, its stages taking turns on the job's worker. It
+ * checks the job's cancel flag and deadline between blocks and counts
+ * payload bytes done. Completion is reported through a callback (which
+ * then owns the job), or for jobs submitted without one, through a
+ * blocking job_wait (the future) and an eventfd the loop can poll
+ * together with executor_reap, which unlinks the job and hands it back
+ * to the caller to free. Modes that bypass the pipeline (--adaptive,
+ * --channels, --append, --update, --auto-cover) are refused.
+ */
+
+#define EXECUTOR_MAX_THREADS 64
+#define JOB_MAX_OPTIONS 16
+
+typedef enum
+{
+    e_job_queued,
+    e_job_running,
+    e_job_done,
+    e_job_failed,
+    e_job_cancelled,
+    e_job_expired
+} JobState;
+
+/* Shared between a job and the pipeline running it */
+typedef struct _JobControl
+{
+    _Atomic int cancel;              // Set by job_cancel
+    long long deadline_ms;           // CLOCK_MONOTONIC milliseconds, 0 for none
+    _Atomic unsigned long long done; // Payload bytes embedded or extracted so far
+    _Atomic unsigned long long total; // Payload bytes the pipeline will embed or extract
+} JobControl;
+
+typedef struct _StegoJob
+{
+    OperationType op; // e_encode or e_decode
+    EncodeInfo enc;
+    DecodeInfo dec;
+    JobControl control;
+    void (*on_done)(struct _StegoJob *job, JobState state, void *arg); // Runs on a worker thread, NULL to reap
+    void *arg;
+    JobState state;               // Guarded by the executor lock
+    struct _Executor *executor;
+    struct _StegoJob *next;
+} StegoJob;
+
+typedef struct _Executor
+{
+    pthread_t threads[EXECUTOR_MAX_THREADS];
+    int nthreads;
+    pthread_mutex_t lock;
+    pthread_cond_t work_cond;     // A job was queued or shutdown started
+    pthread_cond_t done_cond;     // A job finished
+    StegoJob *head, *tail;        // Queued jobs
+    StegoJob *done_head, *done_tail; // Finished jobs without a callback
+    int done_fd;                  // eventfd, readable while finished jobs wait to be reaped
+    int shutdown;
+} Executor;
+
+/* Start nthreads workers (0 = the host profile, else one per CPU) */
+Status executor_init(Executor *executor, int nthreads);
+
+/* Cancel queued jobs, wait for running ones and stop the workers */
+void executor_shutdown(Executor *executor);
+
+/* Prepare an encode job; options are CLI options such as "--verify", NULL-terminated or NULL */
+Status job_init_encode(StegoJob *job, char *src_image, char *secret, char *stego_image, char *options[]);
+
+/* Prepare a decode job; output may be NULL for the default name */
+Status job_init_decode(StegoJob *job, char *stego_image, char *output, char *options[]);
+
+/* Queue a job; timeout_ms of 0 means no deadline */
+Status executor_submit(Executor *executor, StegoJob *job, void (*on_done)(StegoJob *job, JobState state, void *arg), void *arg, long long timeout_ms);
+
+/* Ask a queued or running job to stop at the next block */
+void job_cancel(StegoJob *job);
+
+/* Block until a job submitted without a callback has finished; returns how it ended */
+JobState job_wait(StegoJob *job);
+
+/* Payload bytes done so far and in total, readable while the job runs */
+void job_progress(StegoJob *job, unsigned long long *done, unsigned long long *total);
+
+/* Next finished job submitted without a callback, NULL if none */
+StegoJob *executor_reap(Executor *executor);
+
+/* Has the job been cancelled or run past its deadline? */
+int job_control_should_stop(JobControl *control);
+
+#endif
@@ -0,0 +1,311 @@
+/*
+Documentation
+Name       :G Gangadhar
+Date       :30/07/2025
+Description:Steganography project
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <dirent.h>
+#include <unistd.h>
+#include <utime.h>
+#include <sys/file.h>
+#include <sys/ioctl.h>
+#include <sys/stat.h>
+#include <linux/fs.h>
+#include "cache.h"
+#include "checksum.h"
+#include "encode.h"
+#include "types.h"
+
+/* One cached image, for LRU eviction */
+typedef struct _CacheEntry
+{
+    char name[CACHE_KEY_SIZE + 8];
+    long long mtime; // Nanoseconds, so entries from the same second still order
+    long long size;
+} CacheEntry;
+
+// XXH64 of a whole file, streamed in chunks; matches xxhsum -H64
+static Status hash_file(const char *fname, unsigned long long *hash)
+{
+    char *buffer = malloc(CACHE_HASH_CHUNK);
+    FILE *fptr = fopen(fname, "r");
+    Xxh64State state;
+    size_t n;
+
+    *hash = 0;
+    if (buffer == NULL || fptr == NULL)
+    {
+        free(buffer);
+        if (fptr != NULL)
+        {
+            fclose(fptr);
+        }
+        return e_failure;
+    }
+    xxh64_reset(&state, 0);
+    while ((n = fread(buffer, 1, CACHE_HASH_CHUNK, fptr)) > 0)
+    {
+        xxh64_update(&state, buffer, n);
+    }
+    *hash = xxh64_digest(&state);
+    free(buffer);
+    fclose(fptr);
+    return e_success;
+}
+
+// Add to the hit/miss/eviction counters kept in the cache directory
+static void update_stats(const char *dir, int hits, int misses, int evictions)
+{
+    char path[PATH_MAX + 16];
+    unsigned long long h = 0, m = 0, e = 0;
+    int fd;
+    FILE *fptr;
+
+    snprintf(path, sizeof(path), "%s/%s", dir, CACHE_STATS_FNAME);
+    fd = open(path, O_RDWR | O_CREAT, 0644);
+    if (fd < 0 || (fptr = fdopen(fd, "r+")) == NULL)
+    {
+        if (fd >= 0)
+        {
+            close(fd);
+        }
+        return;
+    }
+    flock(fd, LOCK_EX);
+    if (fscanf(fptr, "hits %llu misses %llu evictions %llu", &h, &m, &e) != 3)
+    {
+        h = m = e = 0;
+    }
+    h += hits;
+    m += misses;
+    e += evictions;
+    rewind(fptr);
+    if (ftruncate(fd, 0) == 0)
+    {
+        fprintf(fptr, "hits %llu\nmisses %llu\nevictions %llu\n", h, m, e);
+    }
+    fflush(fptr);
+    flock(fd, LOCK_UN);
+    fclose(fptr);
+    printf("[INFO] Cache: %llu hits, %llu misses, %llu evictions\n", h, m, e);
+}
+
+// Give dst src's data: reflink if the filesystem can, else a copy; never a shared inode
+static Status clone_file(const char *src, const char *dst)
+{
+    char buffer[1 << 16];
+    ssize_t n;
+    int in, out;
+
+    unlink(dst);
+    in = open(src, O_RDONLY);
+    if (in < 0)
+    {
+        return e_failure;
+    }
+    out = open(dst, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (out < 0)
+    {
+        close(in);
+        return e_failure;
+    }
+    if (ioctl(out, FICLONE, in) == 0)
+    {
+        close(in);
+        close(out);
+        return e_success;
+    }
+
+    // No reflinks here: fall back to a plain copy
+    while ((n = read(in, buffer, sizeof(buffer))) > 0)
+    {
+        if (write(out, buffer, n) != n)
+        {
+            n = -1;
+            break;
+        }
+    }
+    close(in);
+    if (close(out) != 0 || n < 0)
+    {
+        unlink(dst);
+        return e_failure;
+    }
+    return e_success;
+}
+
+// Oldest first
+static int compare_mtime(const void *a, const void *b)
+{
+    const CacheEntry *x = a, *y = b;
+    if (x->mtime != y->mtime)
+    {
+        return x->mtime < y->mtime ? -1 : 1;
+    }
+    return strcmp(x->name, y->name);
+}
+
+// Delete least recently used entries, never keep_name, until the cache is within max_bytes
+static int evict_lru(const char *dir, const char *keep_name, unsigned long long max_bytes)
+{
+    CacheEntry *entries = NULL;
+    uint count = 0, size = 0, i;
+    unsigned long long total = 0;
+    int evicted = 0;
+    struct dirent *dent;
+    DIR *dptr = opendir(dir);
+
+    if (dptr == NULL)
+    {
+        return 0;
+    }
+    while ((dent = readdir(dptr)) != NULL)
+    {
+        char path[PATH_MAX + CACHE_KEY_SIZE + 8];
+        struct stat st;
+
+        // Entries are <key>.<extension>; stats and temporary files are left alone
+        if (strspn(dent->d_name, "0123456789abcdef") != CACHE_KEY_SIZE - 1 || dent->d_name[CACHE_KEY_SIZE - 1] != '.' ||
+            strchr(dent->d_name + CACHE_KEY_SIZE, '.') != NULL || strlen(dent->d_name) >= sizeof(entries->name))
+        {
+            continue;
+        }
+        snprintf(path, sizeof(path), "%s/%s", dir, dent->d_name);
+        if (stat(path, &st) != 0)
+        {
+            continue;
+        }
+        if (count == size)
+        {
+            size = size ? size * 2 : 64;
+            CacheEntry *grown = realloc(entries, size * sizeof(CacheEntry));
+            if (grown == NULL)
+            {
+                break;
+            }
+            entries = grown;
+        }
+        snprintf(entries[count].name, sizeof(entries->name), "%s", dent->d_name);
+        entries[count].mtime = st.st_mtim.tv_sec * 1000000000LL + st.st_mtim.tv_nsec;
+        entries[count].size = st.st_size;
+        total += st.st_size;
+        count++;
+    }
+    closedir(dptr);
+
+    qsort(entries, count, sizeof(CacheEntry), compare_mtime);
+    for (i = 0; i < count && total > max_bytes; i++)
+    {
+        char path[PATH_MAX + CACHE_KEY_SIZE + 8];
+        if (strcmp(entries[i].name, keep_name) == 0)
+        {
+            continue;
+        }
+        snprintf(path, sizeof(path), "%s/%s", dir, entries[i].name);
+        if (unlink(path) == 0)
+        {
+            total -= entries[i].size;
+            evicted++;
+        }
+    }
+    free(entries);
+    return evicted;
+}
+
+// File name of the entry: the key plus the output's extension, so each output format is cached apart
+static void entry_name(EncodeInfo *encInfo, char *name, size_t size)
+{
+    const char *base = strrchr(encInfo->stego_image_fname, '/');
+    const char *extn = strrchr(base != NULL ? base + 1 : encInfo->stego_image_fname, '.');
+    if (extn == NULL || strlen(extn) > MAX_FILE_SUFFIX)
+    {
+        extn = ".bmp";
+    }
+    snprintf(name, size, "%s%s", encInfo->cache_key, extn);
+}
+
+// Key = XXH64(cover) . XXH64(secret) . XXH64(encode options)
+Status cache_make_key(EncodeInfo *encInfo)
+{
+    unsigned long long cover_hash, secret_hash;
+    char params[128];
+
+    if (hash_file(encInfo->src_image_fname, &cover_hash) == e_failure ||
+        hash_file(encInfo->secret_fname, &secret_hash) == e_failure)
+    {
+        printf("ERROR: ❌ Unable to hash %s and %s for the cache\n", encInfo->src_image_fname, encInfo->secret_fname);
+        return e_failure;
+    }
+    int n = snprintf(params, sizeof(params), "v1 matrix=%d verify=%d adaptive=%d channels=%d extn=%s",
+                     encInfo->matrix_k, encInfo->verify, encInfo->adaptive, encInfo->channels, encInfo->extn_secret_file);
+    // Keys of BMP to BMP jobs are unchanged; an adapted cover adds its output format and frame size
+    if (encInfo->src_format != e_format_bmp)
+    {
+        n += snprintf(params + n, sizeof(params) - n, " out=%d raw=%ux%u", encInfo->stego_format, encInfo->raw_width, encInfo->raw_height);
+    }
+    snprintf(encInfo->cache_key, sizeof(encInfo->cache_key), "%016llx%016llx%016llx",
+             cover_hash, secret_hash, xxh64(params, n, 0));
+    return e_success;
+}
+
+// On a hit, clone the stored image to the output and refresh its LRU stamp
+Status cache_lookup(EncodeInfo *encInfo)
+{
+    char path[PATH_MAX + CACHE_KEY_SIZE + 8], name[CACHE_KEY_SIZE + 8];
+
+    if (mkdir(encInfo->cache_dir, 0755) != 0 && errno != EEXIST)
+    {
+        perror("mkdir");
+        return e_failure;
+    }
+    if (cache_make_key(encInfo) == e_failure)
+    {
+        return e_failure;
+    }
+    entry_name(encInfo, name, sizeof(name));
+    snprintf(path, sizeof(path), "%s/%s", encInfo->cache_dir, name);
+    if (access(path, R_OK) != 0 || clone_file(path, encInfo->stego_image_fname) == e_failure)
+    {
+        update_stats(encInfo->cache_dir, 0, 1, 0);
+        return e_failure;
+    }
+    utime(path, NULL);
+    printf("[INFO] Cache hit %s -> %s\n", encInfo->cache_key, encInfo->stego_image_fname);
+    update_stats(encInfo->cache_dir, 1, 0, 0);
+    return e_success;
+}
+
+// Publish the output under its key, then evict down to the size bound
+Status cache_store(EncodeInfo *encInfo)
+{
+    char path[PATH_MAX + CACHE_KEY_SIZE + 8], tmp_path[sizeof(path) + 16], name[CACHE_KEY_SIZE + 8];
+
+    if (encInfo->cache_key[0] == '\0')
+    {
+        return e_failure;
+    }
+
+    entry_name(encInfo, name, sizeof(name));
+    snprintf(path, sizeof(path), "%s/%s", encInfo->cache_dir, name);
+    snprintf(tmp_path, sizeof(tmp_path), "%s.%ld.tmp", path, (long)getpid());
+    if (clone_file(encInfo->stego_image_fname, tmp_path) == e_failure || rename(tmp_path, path) != 0)
+    {
+        unlink(tmp_path);
+        printf("ERROR: ❌ Unable to store %s in the cache\n", encInfo->stego_image_fname);
+        return e_failure;
+    }
+    utime(path, NULL);
+
+    int evicted = evict_lru(encInfo->cache_dir, name, (unsigned long long)encInfo->cache_max_mb << 20);
+    if (evicted > 0)
+    {
+        update_stats(encInfo->cache_dir, 0, 0, evicted);
+    }
+    printf("[INFO] Cached %s as %s\n", encInfo->stego_image_fname, encInfo->cache_key);
+    return e_success;
+}
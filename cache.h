@@ -0,0 +1,31 @@
+#ifndef CACHE_H
+#define CACHE_H
+
+#include "encode.h" // EncodeInfo
+#include "types.h"  // User-defined data types
+
+/*
+ * Content-addressed cache of encode results.
+ * The key is the XXH64 of the cover, of the secret and of the encode
+ * options; a hit reflinks (or copies) the stored stego image to the
+ * output instead of encoding again, so the output never shares an inode
+ * with the entry. An entry is named <key> plus the output's extension.
+ * Entries are evicted least recently used first once the cache grows
+ * past its size bound.
+ */
+
+#define CACHE_ENV_DIR "STEGO_CACHE_DIR"
+#define CACHE_DEFAULT_MAX_MB 1024
+#define CACHE_STATS_FNAME "stats"
+#define CACHE_HASH_CHUNK (1 << 20)
+
+/* Compute the cache key of an encode job into encInfo->cache_key */
+Status cache_make_key(EncodeInfo *encInfo);
+
+/* Clone a cached result to the output image; e_failure on a miss */
+Status cache_lookup(EncodeInfo *encInfo);
+
+/* Store the freshly written output image and evict down to the size bound */
+Status cache_store(EncodeInfo *encInfo);
+
+#endif
@@ -0,0 +1,467 @@
+/*
+Documentation
+Name       :G Gangadhar
+Date       :30/07/2025
+Description:Steganography project
+*/
+#define _GNU_SOURCE // fopencookie
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <unistd.h>
+#include "arena.h"
+#include "channels.h"
+#include "checksum.h"
+#include "common.h"
+#include "encode.h"
+#include "matrix.h"
+#include "plan.h"
+#include "types.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <tmmintrin.h>
+#define CHANNEL_HAVE_SSSE3 1
+#endif
+
+static const char channel_letters[] = "BGRA";
+
+// Letters in any order and case; anything else is an error (0)
+int channel_parse_mask(const char *letters)
+{
+    int mask = 0;
+    for (; *letters != '\0'; letters++)
+    {
+        const char *at = strchr(channel_letters, toupper((unsigned char)*letters));
+        if (at == NULL)
+        {
+            return 0;
+        }
+        mask |= 1 << (at - channel_letters);
+    }
+    return mask;
+}
+
+// Letters in pixel byte order
+void channel_mask_name(int mask, char *name)
+{
+    int i;
+    for (i = 0; i < 4; i++)
+    {
+        if (mask & (1 << i))
+        {
+            *name++ = channel_letters[i];
+        }
+    }
+    *name = '\0';
+}
+
+// The shuffles are compiled for SSSE3 on any x86 build and only used when the CPU has it
+static int have_ssse3(void)
+{
+#ifdef CHANNEL_HAVE_SSSE3
+    return __builtin_cpu_supports("ssse3");
+#else
+    return 0;
+#endif
+}
+
+// Shuffle controls for 16 pixels: 0x80 clears a byte, so partial shuffles can be ORed together
+static void build_shuffles(ChannelLayout *layout)
+{
+    int p, k;
+
+    memset(layout->gather, 0x80, sizeof(layout->gather));
+    memset(layout->scatter, 0x80, sizeof(layout->scatter));
+    memset(layout->keep, 0xFF, sizeof(layout->keep));
+    for (p = 0; p < 16; p++)
+    {
+        for (k = 0; k < layout->count; k++)
+        {
+            int in = p * layout->pixel_bytes + layout->index[k];
+            int out = p * layout->count + k;
+            layout->gather[out / 16][in / 16][out % 16] = in % 16;
+            layout->scatter[in / 16][out / 16][in % 16] = out % 16;
+            layout->keep[in / 16][in % 16] = 0;
+        }
+    }
+}
+
+// Width, height, bit count and pixel array offset from the BMP header; the file position is kept
+Status channel_layout(FILE *fptr_image, int mask, ChannelLayout *layout)
+{
+    unsigned char header[54];
+    long long pos = ftello(fptr_image);
+    unsigned int offset;
+    unsigned short bpp;
+    int width, height, i;
+
+    memset(layout, 0, sizeof(*layout));
+    fseeko(fptr_image, 0, SEEK_SET);
+    if (fread(header, sizeof(header), 1, fptr_image) != 1)
+    {
+        fseeko(fptr_image, pos, SEEK_SET);
+        return e_failure;
+    }
+    fseeko(fptr_image, pos, SEEK_SET);
+    memcpy(&offset, header + 10, 4);
+    memcpy(&width, header + 18, 4);
+    memcpy(&height, header + 22, 4);
+    memcpy(&bpp, header + 28, 2);
+    if ((bpp != 24 && bpp != 32) || width <= 0 || height == 0 || offset < CHANNEL_LANE_BASE ||
+        mask <= 0 || mask > 0xF || ((mask & CHANNEL_A) && bpp != 32))
+    {
+        return e_failure;
+    }
+
+    layout->mask = mask;
+    layout->pixel_bytes = bpp / 8;
+    for (i = 0; i < 4; i++)
+    {
+        if (mask & (1 << i))
+        {
+            layout->index[layout->count++] = i;
+        }
+    }
+    layout->width = width;
+    layout->rows = llabs(height);
+    layout->stride = ((long long)width * bpp + 31) / 32 * 4;
+    layout->pixel_offset = offset;
+    layout->lane_row = layout->width * layout->count;
+    layout->simd = have_ssse3();
+    build_shuffles(layout);
+    return e_success;
+}
+
+#ifdef CHANNEL_HAVE_SSSE3
+// 16 pixels per step: every lane vector is the OR of one shuffle per pixel vector
+__attribute__((target("ssse3"))) static long long gather_ssse3(const ChannelLayout *layout, const char *pixels, long long n, char *lane)
+{
+    long long p;
+    int i, j;
+
+    for (p = 0; p + 16 <= n; p += 16)
+    {
+        const __m128i *src = (const __m128i *)(pixels + p * layout->pixel_bytes);
+        __m128i *dst = (__m128i *)(lane + p * layout->count);
+        __m128i in[4];
+        for (i = 0; i < layout->pixel_bytes; i++)
+        {
+            in[i] = _mm_loadu_si128(src + i);
+        }
+        for (j = 0; j < layout->count; j++)
+        {
+            __m128i out = _mm_setzero_si128();
+            for (i = 0; i < layout->pixel_bytes; i++)
+            {
+                out = _mm_or_si128(out, _mm_shuffle_epi8(in[i], _mm_loadu_si128((const __m128i *)layout->gather[j][i])));
+            }
+            _mm_storeu_si128(dst + j, out);
+        }
+    }
+    return p;
+}
+
+// The reverse: unselected bytes are kept, selected ones come from the lane vectors
+__attribute__((target("ssse3"))) static long long scatter_ssse3(const ChannelLayout *layout, const char *lane, long long n, char *pixels)
+{
+    long long p;
+    int i, j;
+
+    for (p = 0; p + 16 <= n; p += 16)
+    {
+        const __m128i *src = (const __m128i *)(lane + p * layout->count);
+        __m128i *dst = (__m128i *)(pixels + p * layout->pixel_bytes);
+        __m128i in[4];
+        for (j = 0; j < layout->count; j++)
+        {
+            in[j] = _mm_loadu_si128(src + j);
+        }
+        for (i = 0; i < layout->pixel_bytes; i++)
+        {
+            __m128i out = _mm_and_si128(_mm_loadu_si128(dst + i), _mm_loadu_si128((const __m128i *)layout->keep[i]));
+            for (j = 0; j < layout->count; j++)
+            {
+                out = _mm_or_si128(out, _mm_shuffle_epi8(in[j], _mm_loadu_si128((const __m128i *)layout->scatter[i][j])));
+            }
+            _mm_storeu_si128(dst + i, out);
+        }
+    }
+    return p;
+}
+#endif
+
+void channel_gather(const ChannelLayout *layout, const char *pixels, long long n, char *lane)
+{
+    long long p = 0;
+    int k;
+
+#ifdef CHANNEL_HAVE_SSSE3
+    if (layout->simd)
+    {
+        p = gather_ssse3(layout, pixels, n, lane);
+    }
+#endif
+    for (; p < n; p++)
+    {
+        for (k = 0; k < layout->count; k++)
+        {
+            lane[p * layout->count + k] = pixels[p * layout->pixel_bytes + layout->index[k]];
+        }
+    }
+}
+
+void channel_scatter(const ChannelLayout *layout, const char *lane, long long n, char *pixels)
+{
+    long long p = 0;
+    int k;
+
+#ifdef CHANNEL_HAVE_SSSE3
+    if (layout->simd)
+    {
+        p = scatter_ssse3(layout, lane, n, pixels);
+    }
+#endif
+    for (; p < n; p++)
+    {
+        for (k = 0; k < layout->count; k++)
+        {
+            pixels[p * layout->pixel_bytes + layout->index[k]] = lane[p * layout->count + k];
+        }
+    }
+}
+
+typedef struct _LaneStream
+{
+    ChannelLayout layout;
+    int fd;                          // The image, read with pread so its FILE position is untouched
+    char head[CHANNEL_LANE_BASE];    // Image bytes shown before the lane
+    long long pos;                   // Stream position
+    long long size;                  // Head plus lane bytes
+    char *pixels;                    // Pixel rows being read
+    char *lane;                      // Their lane bytes
+    long long first;                 // First row in lane
+    long long count;                 // Rows in lane
+    long long chunk;                 // Rows read at once
+} LaneStream;
+
+// Read and gather the chunk of rows starting at row
+static Status load_rows(LaneStream *ls, long long row)
+{
+    const ChannelLayout *layout = &ls->layout;
+    long long count = layout->rows - row < ls->chunk ? layout->rows - row : ls->chunk, i;
+    ssize_t len = count * layout->stride;
+
+    if (pread(ls->fd, ls->pixels, len, layout->pixel_offset + row * layout->stride) != len)
+    {
+        return e_failure;
+    }
+    for (i = 0; i < count; i++)
+    {
+        channel_gather(layout, ls->pixels + i * layout->stride, layout->width, ls->lane + i * layout->lane_row);
+    }
+    ls->first = row;
+    ls->count = count;
+    return e_success;
+}
+
+static ssize_t lane_read(void *cookie, char *buf, size_t size)
+{
+    LaneStream *ls = cookie;
+    const ChannelLayout *layout = &ls->layout;
+    size_t done = 0, n;
+
+    while (done < size && ls->pos < ls->size)
+    {
+        if (ls->pos < CHANNEL_LANE_BASE)
+        {
+            n = CHANNEL_LANE_BASE - ls->pos;
+            n = n < size - done ? n : size - done;
+            memcpy(buf + done, ls->head + ls->pos, n);
+        }
+        else
+        {
+            long long at = ls->pos - CHANNEL_LANE_BASE, row = at / layout->lane_row;
+            if ((row < ls->first || row >= ls->first + ls->count) && load_rows(ls, row) == e_failure)
+            {
+                return done > 0 ? (ssize_t)done : -1;
+            }
+            at -= ls->first * layout->lane_row;
+            n = ls->count * layout->lane_row - at;
+            n = n < size - done ? n : size - done;
+            memcpy(buf + done, ls->lane + at, n);
+        }
+        done += n;
+        ls->pos += n;
+    }
+    return done;
+}
+
+static int lane_seek(void *cookie, off64_t *offset, int whence)
+{
+    LaneStream *ls = cookie;
+    long long pos = whence == SEEK_SET ? *offset : whence == SEEK_CUR ? ls->pos + *offset : ls->size + *offset;
+    if (pos < 0)
+    {
+        return -1;
+    }
+    ls->pos = pos;
+    *offset = pos;
+    return 0;
+}
+
+static int lane_close(void *cookie)
+{
+    LaneStream *ls = cookie;
+    arena_free(ls->pixels);
+    arena_free(ls->lane);
+    free(ls);
+    return 0;
+}
+
+FILE *channel_open_lane(FILE *fptr_image, const ChannelLayout *layout)
+{
+    cookie_io_functions_t io = {lane_read, NULL, lane_seek, lane_close};
+    LaneStream *ls = calloc(1, sizeof(LaneStream));
+    FILE *fptr;
+
+    if (ls == NULL)
+    {
+        return NULL;
+    }
+    ls->layout = *layout;
+    ls->fd = fileno(fptr_image);
+    ls->size = CHANNEL_LANE_BASE + layout->rows * layout->lane_row;
+    ls->chunk = CHANNEL_LANE_CHUNK / layout->stride > 0 ? CHANNEL_LANE_CHUNK / layout->stride : 1;
+    ls->pixels = arena_alloc(ls->chunk * layout->stride);
+    ls->lane = arena_alloc(ls->chunk * layout->lane_row);
+    if (ls->pixels == NULL || ls->lane == NULL || pread(ls->fd, ls->head, CHANNEL_LANE_BASE, 0) != CHANNEL_LANE_BASE ||
+        (fptr = fopencookie(ls, "r", io)) == NULL)
+    {
+        lane_close(ls);
+        return NULL;
+    }
+    return fptr;
+}
+
+// Copy n bytes, or everything up to EOF when n is negative
+static Status copy_bytes(FILE *fptr_src, FILE *fptr_dest, long long n, char *buffer, size_t size)
+{
+    while (n != 0)
+    {
+        size_t want = n > 0 && (unsigned long long)n < size ? (size_t)n : size;
+        size_t got = fread(buffer, 1, want, fptr_src);
+        if (got == 0)
+        {
+            return n < 0 ? e_success : e_failure;
+        }
+        if (fwrite(buffer, 1, got, fptr_dest) != got)
+        {
+            return e_failure;
+        }
+        if (n > 0)
+        {
+            n -= got;
+        }
+    }
+    return e_success;
+}
+
+// Rows go through the lane in chunks until the payload is in; rows holding the start of a unit cut by the chunk end wait for the next chunk
+Status encode_channel_data(EncodeInfo *encInfo)
+{
+    ChannelLayout layout;
+    EmbedPlan plan;
+    VerifyInfo *verify = get_verify_info(encInfo);
+    FILE *src = encInfo->fptr_src_image, *dest = encInfo->fptr_stego_image;
+    char *secret = NULL, *pixels = NULL, *lane = NULL;
+    long long chunk, carry, held = 0, first = 0, next = 0, done = CHANNEL_LANE_BASE, i;
+    Status status = e_failure;
+
+    if (channel_layout(src, encInfo->channels, &layout) == e_failure)
+    {
+        fprintf(stderr, "ERROR: ❌ %s has no channels to match the mask\n", encInfo->src_image_fname);
+        return e_failure;
+    }
+    encInfo->size_secret_file = get_file_size(encInfo->fptr_secret);
+    chunk = CHANNEL_CHUNK_BYTES / layout.stride > 0 ? CHANNEL_CHUNK_BYTES / layout.stride : 1;
+    carry = PLAN_UNIT_SIZE(MATRIX_MAX_K) / layout.lane_row + 2;
+    secret = arena_alloc(encInfo->size_secret_file + 1);
+    pixels = arena_alloc((chunk + carry) * layout.stride);
+    lane = arena_alloc((chunk + carry) * layout.lane_row);
+    if (secret == NULL || pixels == NULL || lane == NULL)
+    {
+        fprintf(stderr, "ERROR: ❌ Out of memory for the channel lane\n");
+        goto out;
+    }
+    rewind(encInfo->fptr_secret);
+    if (encInfo->size_secret_file > 0 && fread(secret, encInfo->size_secret_file, 1, encInfo->fptr_secret) != 1)
+    {
+        fprintf(stderr, "ERROR: ❌ Failed to read %d bytes from secret file.\n", encInfo->size_secret_file);
+        goto out;
+    }
+    encInfo->secret_crc = crc32_update(0, secret, encInfo->size_secret_file);
+    plan_build(encInfo, secret, &plan);
+
+    // Anything between the 54-byte header and the pixel array is kept as it is
+    if (copy_bytes(src, dest, layout.pixel_offset - CHANNEL_LANE_BASE, pixels, layout.stride) == e_failure)
+    {
+        fprintf(stderr, "ERROR: ❌ Failed to copy %s up to its pixel array\n", encInfo->src_image_fname);
+        goto out;
+    }
+
+    while (first < layout.rows && done < plan.end)
+    {
+        long long n = layout.rows - next < chunk ? layout.rows - next : chunk;
+        long long base = CHANNEL_LANE_BASE + first * layout.lane_row;
+        if ((long long)fread(pixels + held * layout.stride, layout.stride, n, src) != n)
+        {
+            fprintf(stderr, "ERROR: ❌ Failed to read pixel rows from %s\n", encInfo->src_image_fname);
+            goto out;
+        }
+        held += n;
+        next += n;
+        for (i = 0; i < held; i++)
+        {
+            channel_gather(&layout, pixels + i * layout.stride, layout.width, lane + i * layout.lane_row);
+        }
+
+        size_t want = base + held * layout.lane_row - done;
+        size_t len = next == layout.rows ? want : plan_align_block(&plan, done, want);
+        if (len <= want)
+        {
+            plan_embed_block(&plan, done, lane + (done - base), len, verify);
+            done += len;
+            for (i = 0; i < held; i++)
+            {
+                channel_scatter(&layout, lane + i * layout.lane_row, layout.width, pixels + i * layout.stride);
+            }
+        }
+
+        // Rows whose lane bytes all lie before done are final
+        long long ready = next == layout.rows ? held : (done - base) / layout.lane_row;
+        if ((long long)fwrite(pixels, layout.stride, ready, dest) != ready)
+        {
+            fprintf(stderr, "ERROR: ❌ Failed to write pixel rows to %s\n", encInfo->stego_image_fname);
+            goto out;
+        }
+        memmove(pixels, pixels + ready * layout.stride, (held - ready) * layout.stride);
+        held -= ready;
+        first += ready;
+    }
+
+    // The rows still held, the untouched rows and whatever follows the pixel array
+    if ((long long)fwrite(pixels, layout.stride, held, dest) != held ||
+        copy_bytes(src, dest, -1, pixels, layout.stride * chunk) == e_failure)
+    {
+        fprintf(stderr, "ERROR: ❌ Failed to copy the rest of %s\n", encInfo->src_image_fname);
+        goto out;
+    }
+    status = e_success;
+
+out:
+    arena_free(secret);
+    arena_free(pixels);
+    arena_free(lane);
+    return status;
+}
@@ -0,0 +1,71 @@
+#ifndef CHANNELS_H
+#define CHANNELS_H
+
+#include <stdio.h>
+#include "decode.h" // DecodeInfo
+#include "encode.h" // EncodeInfo
+#include "types.h"  // User-defined data types
+
+/*
+ * Channel-mask embedding: the payload goes only into the selected colour
+ * channels of a 24 or 32 bpp image, for instance blue only, or the alpha
+ * channel of a 32 bpp image, and every other byte is left untouched.
+ * The selected bytes of each row, row padding skipped, form a "lane";
+ * lane byte i stands where cover byte 54 + i would, so the header, data
+ * and checksum are laid out in the lane exactly as they are in a plain
+ * image. The mask is stored in the header flags; the decoder finds it by
+ * trying each mask the image's pixel format allows.
+ *
+ * Rows are gathered into the lane and scattered back 16 pixels at a time
+ * with SSSE3 byte shuffles when the CPU has them, else byte by byte.
+ */
+
+/* Channel bits, in the order the bytes sit in a BMP pixel */
+#define CHANNEL_B 0x01
+#define CHANNEL_G 0x02
+#define CHANNEL_R 0x04
+#define CHANNEL_A 0x08
+
+#define CHANNEL_LANE_BASE 54         // Cover offset lane byte 0 stands for
+#define CHANNEL_CHUNK_BYTES (1 << 20) // Pixel rows processed per encode step
+#define CHANNEL_LANE_CHUNK (64 << 10) // Pixel rows the decoder's lane reads at once
+
+typedef struct _ChannelLayout
+{
+    int mask;                 // CHANNEL_* bits
+    int pixel_bytes;          // 3 or 4
+    int count;                // Selected channels per pixel
+    int index[4];             // Byte of each selected channel within a pixel
+    long long width;          // Pixels per row
+    long long rows;           // Pixel rows
+    long long stride;         // Bytes per row, padding included
+    long long pixel_offset;   // File offset of the pixel array
+    long long lane_row;       // Lane bytes per row
+    int simd;                 // Use the SSSE3 shuffles
+    unsigned char gather[4][4][16];  // Lane vector j from pixel vector i, per 16 pixels
+    unsigned char scatter[4][4][16]; // Pixel vector i from lane vector j
+    unsigned char keep[4][16];       // Bytes of pixel vector i outside the mask
+} ChannelLayout;
+
+/* Parse channel letters such as "B", "bg" or "A" into a mask */
+int channel_parse_mask(const char *letters);
+
+/* Write the letters of a mask, at least 5 bytes */
+void channel_mask_name(int mask, char *name);
+
+/* Read the pixel format of a BMP image and lay out the mask's lane */
+Status channel_layout(FILE *fptr_image, int mask, ChannelLayout *layout);
+
+/* Copy the selected bytes of n pixels into the lane */
+void channel_gather(const ChannelLayout *layout, const char *pixels, long long n, char *lane);
+
+/* Copy lane bytes back into the selected bytes of n pixels */
+void channel_scatter(const ChannelLayout *layout, const char *lane, long long n, char *pixels);
+
+/* Open a read-only stream showing the first 54 image bytes, then the lane */
+FILE *channel_open_lane(FILE *fptr_image, const ChannelLayout *layout);
+
+/* Encode the header, data and checksum into the lane and copy the rest of the image */
+Status encode_channel_data(EncodeInfo *encInfo);
+
+#endif
@@ -0,0 +1,57 @@
+#ifndef CHECKSUM_H
+#define CHECKSUM_H
+
+#include <stddef.h>
+#include "types.h" // User-defined data types
+
+/* Running CRC-32 (IEEE), start with crc = 0 */
+uint crc32_update(uint crc, const void *data, size_t len);
+
+/* XXH64 hash of len bytes, for content addressing */
+unsigned long long xxh64(const void *data, size_t len, unsigned long long seed);
+
+/* XXH64 over data fed in pieces; the digest equals xxh64() of the whole */
+typedef struct _Xxh64State
+{
+    unsigned long long v[4];    // Lane accumulators
+    unsigned long long total;   // Bytes fed so far
+    unsigned long long seed;
+    unsigned char mem[32];      // Start of a stripe not yet complete
+    uint memsize;
+} Xxh64State;
+
+/* Start a stream with the given seed */
+void xxh64_reset(Xxh64State *state, unsigned long long seed);
+
+/* Feed len more bytes */
+void xxh64_update(Xxh64State *state, const void *data, size_t len);
+
+/* Hash of all bytes fed so far */
+unsigned long long xxh64_digest(const Xxh64State *state);
+
+/*
+ * State of a verify-after-encode pass. Every window is re-extracted from
+ * the stego buffer just before it is written and checked against the
+ * source bytes; both streams are also folded into a CRC-32.
+ */
+typedef struct _VerifyInfo
+{
+    uint src_crc;             // CRC-32 of the payload handed to the encoder
+    uint out_crc;             // CRC-32 of the payload re-extracted from the stego buffers
+    uint mismatches;          // Bytes whose re-extracted value differs from the source
+    unsigned long long bytes; // Payload bytes verified so far
+    uint matrix_acc;          // Re-extracted matrix bits not yet forming a byte
+    int matrix_bits;          // How many of them there are
+    uint matrix_checked;      // Bytes of the matrix embedded data checked so far
+} VerifyInfo;
+
+/* Reset the verify state */
+void verify_init(VerifyInfo *verify);
+
+/* Check len re-extracted bytes against the source bytes */
+void verify_window(VerifyInfo *verify, const char *expected, const char *extracted, uint len);
+
+/* Final verdict: every byte matched and both checksums agree */
+Status verify_result(const VerifyInfo *verify);
+
+#endif
@@ -4,4 +4,33 @@
 /* Magic string to identify whether stegged or not */
 #define MAGIC_STRING "#*"
 
+/* Cover bytes every payload header takes: BMP header, magic string, extension size and file size */
+#define HEADER_FIXED_SIZE (54 + (sizeof(MAGIC_STRING) - 1 + 4 + 4) * 8)
+
+/*
+ * The extension size field only needs its low byte, so format flags are
+ * packed above it. Images written without flags decode exactly as before.
+ */
+#define EXTN_SIZE_MASK 0xFF
+#define FLAGS_SHIFT 8
+
+/* Largest secret whose bit count still fits the 32-bit size arithmetic */
+#define MAX_SECRET_SIZE 0x1FFFFFFF
+
+/* Secret data uses matrix embedding; the code parameter k sits in bits 4..7 */
+#define FLAG_MATRIX 0x01
+#define FLAG_MATRIX_K_SHIFT 4
+#define FLAG_MATRIX_K_MASK 0xF0
+
+/* A CRC-32 of the secret data follows it as a 32-bit integer */
+#define FLAG_CRC 0x02
+
+/* Secret data sits in the most textured bytes; a checksum comes right after the header */
+#define FLAG_ADAPTIVE 0x04
+
+/* Header and data sit in a subset of the colour channels; the CHANNEL_* mask is in bits 8..11 */
+#define FLAG_CHANNELS 0x08
+#define FLAG_CHANNEL_SHIFT 8
+#define FLAG_CHANNEL_MASK 0xF00
+
 #endif
@@ -0,0 +1,352 @@
+/*
+Documentation
+Name       :G Gangadhar
+Date       :30/07/2025
+Description:Steganography project
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <dirent.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "cover_index.h"
+#include "encode.h"
+#include "types.h"
+
+#define BPP_UNREAD UINT_MAX // Entry whose header is still to be read
+
+/* Shared state of the header scanning workers */
+typedef struct _ScanJob
+{
+    const char *dir;
+    CoverEntry **pending; // Entries whose header must be (re)read
+    uint count;
+    uint next;            // Next pending entry to claim
+    pthread_mutex_t lock;
+} ScanJob;
+
+// Order entries by name for lookups while merging
+static int compare_name(const void *a, const void *b)
+{
+    return strcmp(((const CoverEntry *)a)->name, ((const CoverEntry *)b)->name);
+}
+
+// Order entries by capacity, ties by name so the index is stable
+static int compare_capacity(const void *a, const void *b)
+{
+    const CoverEntry *x = a, *y = b;
+    if (x->capacity != y->capacity)
+    {
+        return x->capacity < y->capacity ? -1 : 1;
+    }
+    return strcmp(x->name, y->name);
+}
+
+// Little-endian 32-bit field from a BMP header
+static uint read_le32(const unsigned char *p)
+{
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint)p[3] << 24);
+}
+
+// Read only the 54-byte header of a cover and fill in its geometry
+static Status read_cover_header(const char *dir, CoverEntry *entry)
+{
+    char path[PATH_MAX];
+    unsigned char header[54];
+    FILE *fptr;
+
+    snprintf(path, sizeof(path), "%s/%s", dir, entry->name);
+    fptr = fopen(path, "r");
+    if (fptr == NULL)
+    {
+        return e_failure;
+    }
+    if (fread(header, sizeof(header), 1, fptr) != 1 || header[0] != 'B' || header[1] != 'M')
+    {
+        fclose(fptr);
+        return e_failure;
+    }
+    fclose(fptr);
+
+    int height = (int)read_le32(header + 22);
+    entry->pixel_offset = read_le32(header + 10);
+    entry->width = read_le32(header + 18);
+    entry->height = height < 0 ? -height : height;
+    entry->bpp = header[28] | (header[29] << 8);
+    // Same measure as check_capacity: three bytes a pixel, less the fixed header
+    entry->capacity = cover_payload_capacity((unsigned long long)entry->width * entry->height * 3);
+    return e_success;
+}
+
+// Worker: claim pending entries one at a time and read their headers
+static void *scan_worker(void *arg)
+{
+    ScanJob *job = arg;
+    while (1)
+    {
+        pthread_mutex_lock(&job->lock);
+        uint i = job->next++;
+        pthread_mutex_unlock(&job->lock);
+        if (i >= job->count)
+        {
+            break;
+        }
+        if (read_cover_header(job->dir, job->pending[i]) == e_failure)
+        {
+            // Kept as unusable until the file changes
+            job->pending[i]->width = job->pending[i]->height = 0;
+            job->pending[i]->pixel_offset = 0;
+            job->pending[i]->capacity = 0;
+            job->pending[i]->bpp = 0;
+        }
+    }
+    return NULL;
+}
+
+// Read the headers of all pending entries on a small thread pool
+static void scan_pending(const char *dir, CoverEntry **pending, uint count)
+{
+    pthread_t threads[COVER_INDEX_MAX_THREADS];
+    ScanJob job = {dir, pending, count, 0, PTHREAD_MUTEX_INITIALIZER};
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    int i, nthreads = cpus < 1 ? 1 : (cpus > COVER_INDEX_MAX_THREADS ? COVER_INDEX_MAX_THREADS : cpus);
+
+    if ((uint)nthreads > count)
+    {
+        nthreads = count;
+    }
+    for (i = 0; i < nthreads; i++)
+    {
+        if (pthread_create(&threads[i], NULL, scan_worker, &job) != 0)
+        {
+            break;
+        }
+    }
+    // Whatever could not be handed to a thread is scanned here
+    scan_worker(&job);
+    while (i-- > 0)
+    {
+        pthread_join(threads[i], NULL);
+    }
+}
+
+// Load a previously saved index, an empty one if missing or outdated
+static void load_index(const char *path, CoverIndex *index)
+{
+    char line[COVER_NAME_SIZE + 128];
+    uint size = 0;
+    FILE *fptr = fopen(path, "r");
+
+    index->entries = NULL;
+    index->count = 0;
+    if (fptr == NULL)
+    {
+        return;
+    }
+    if (fgets(line, sizeof(line), fptr) == NULL || strncmp(line, COVER_INDEX_VERSION, strlen(COVER_INDEX_VERSION)) != 0)
+    {
+        fclose(fptr);
+        return;
+    }
+    while (fgets(line, sizeof(line), fptr) != NULL)
+    {
+        CoverEntry entry;
+        int name_at = 0;
+        if (sscanf(line, "%llu %u %u %u %u %lld %lld %n", &entry.capacity, &entry.width, &entry.height,
+                   &entry.bpp, &entry.pixel_offset, &entry.mtime, &entry.file_size, &name_at) != 7 ||
+            name_at == 0)
+        {
+            continue;
+        }
+        line[strcspn(line, "\n")] = '\0';
+        snprintf(entry.name, sizeof(entry.name), "%s", line + name_at);
+
+        if (index->count == size)
+        {
+            size = size ? size * 2 : 64;
+            CoverEntry *grown = realloc(index->entries, size * sizeof(CoverEntry));
+            if (grown == NULL)
+            {
+                break;
+            }
+            index->entries = grown;
+        }
+        index->entries[index->count++] = entry;
+    }
+    fclose(fptr);
+}
+
+// Write the index to a temporary file and rename it over the old one
+static Status save_index(const char *path, const CoverIndex *index)
+{
+    char tmp_path[PATH_MAX + 8];
+    uint i;
+    FILE *fptr;
+
+    snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", path);
+    fptr = fopen(tmp_path, "w");
+    if (fptr == NULL)
+    {
+        perror("fopen");
+        return e_failure;
+    }
+    fprintf(fptr, "%s\n", COVER_INDEX_VERSION);
+    for (i = 0; i < index->count; i++)
+    {
+        const CoverEntry *e = &index->entries[i];
+        fprintf(fptr, "%llu %u %u %u %u %lld %lld %s\n", e->capacity, e->width, e->height,
+                e->bpp, e->pixel_offset, e->mtime, e->file_size, e->name);
+    }
+    if (fclose(fptr) != 0 || rename(tmp_path, path) != 0)
+    {
+        perror("ERROR");
+        remove(tmp_path);
+        return e_failure;
+    }
+    return e_success;
+}
+
+// Bring the index of dir up to date, reading headers only for new or changed covers
+Status cover_index_update(const char *dir, CoverIndex *index)
+{
+    char path[PATH_MAX];
+    CoverIndex old;
+    CoverEntry **pending = NULL;
+    uint size = 0, npending = 0, reused = 0, i;
+    struct dirent *dent;
+    DIR *dptr;
+
+    index->dir = dir;
+    index->entries = NULL;
+    index->count = 0;
+
+    dptr = opendir(dir);
+    if (dptr == NULL)
+    {
+        perror("opendir");
+        fprintf(stderr, "ERROR: ❌ Unable to open cover directory %s\n", dir);
+        return e_failure;
+    }
+
+    snprintf(path, sizeof(path), "%s/%s", dir, COVER_INDEX_FNAME);
+    load_index(path, &old);
+    qsort(old.entries, old.count, sizeof(CoverEntry), compare_name);
+
+    while ((dent = readdir(dptr)) != NULL)
+    {
+        char *bmp = strstr(dent->d_name, ".bmp");
+        char cover_path[PATH_MAX];
+        struct stat st;
+
+        if (bmp == NULL || strcmp(bmp, ".bmp") != 0 || strlen(dent->d_name) >= COVER_NAME_SIZE)
+        {
+            continue;
+        }
+        snprintf(cover_path, sizeof(cover_path), "%s/%s", dir, dent->d_name);
+        if (stat(cover_path, &st) != 0 || !S_ISREG(st.st_mode))
+        {
+            continue;
+        }
+
+        if (index->count == size)
+        {
+            size = size ? size * 2 : 64;
+            CoverEntry *grown = realloc(index->entries, size * sizeof(CoverEntry));
+            if (grown == NULL)
+            {
+                closedir(dptr);
+                free(old.entries);
+                cover_index_free(index);
+                return e_failure;
+            }
+            index->entries = grown;
+        }
+
+        // Reuse the old entry while the file is unchanged
+        CoverEntry *entry = &index->entries[index->count++];
+        CoverEntry *prev;
+        snprintf(entry->name, sizeof(entry->name), "%s", dent->d_name);
+        prev = bsearch(entry, old.entries, old.count, sizeof(CoverEntry), compare_name);
+        if (prev != NULL && prev->mtime == (long long)st.st_mtime && prev->file_size == (long long)st.st_size)
+        {
+            *entry = *prev;
+            reused++;
+            continue;
+        }
+        entry->mtime = st.st_mtime;
+        entry->file_size = st.st_size;
+        entry->bpp = BPP_UNREAD;
+    }
+    closedir(dptr);
+
+    // Pointers are taken only now, once the array has stopped moving
+    for (i = 0; i < index->count; i++)
+    {
+        if (index->entries[i].bpp == BPP_UNREAD)
+        {
+            npending++;
+        }
+    }
+    if (npending > 0)
+    {
+        uint j = 0;
+        pending = malloc(npending * sizeof(CoverEntry *));
+        if (pending == NULL)
+        {
+            free(old.entries);
+            cover_index_free(index);
+            return e_failure;
+        }
+        for (i = 0; i < index->count; i++)
+        {
+            if (index->entries[i].bpp == BPP_UNREAD)
+            {
+                pending[j++] = &index->entries[i];
+            }
+        }
+        scan_pending(dir, pending, npending);
+        free(pending);
+    }
+
+    // Files that are not usable covers stay in with capacity 0, so they are not read again until they change
+    qsort(index->entries, index->count, sizeof(CoverEntry), compare_capacity);
+
+    printf("[INFO] Cover index %s: %u covers, %u reused, %u rescanned\n", path, index->count, reused, npending);
+    free(old.entries);
+
+    if (npending > 0 || reused != old.count)
+    {
+        return save_index(path, index);
+    }
+    return e_success;
+}
+
+// Lower-bound binary search on capacity
+const CoverEntry *cover_index_best_fit(const CoverIndex *index, unsigned long long required)
+{
+    uint lo = 0, hi = index->count;
+    while (lo < hi)
+    {
+        uint mid = lo + (hi - lo) / 2;
+        if (index->entries[mid].capacity >= required)
+        {
+            hi = mid;
+        }
+        else
+        {
+            lo = mid + 1;
+        }
+    }
+    return lo < index->count ? &index->entries[lo] : NULL;
+}
+
+// Free the entries of an index
+void cover_index_free(CoverIndex *index)
+{
+    free(index->entries);
+    index->entries = NULL;
+    index->count = 0;
+}
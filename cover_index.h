@@ -0,0 +1,48 @@
+#ifndef COVER_INDEX_H
+#define COVER_INDEX_H
+
+#include "types.h" // User-defined data types
+
+/*
+ * Persistent index of the cover images in a directory.
+ * Only the BMP headers are read; entries are kept sorted by capacity so
+ * the smallest cover that fits a secret is found with a binary search.
+ * Capacity is what check_capacity counts, three bytes a pixel, less the
+ * fixed part of the payload header; files that are not BMPs are kept with
+ * capacity 0 so unchanged ones are not read again.
+ */
+
+#define COVER_INDEX_FNAME ".stego_index"
+#define COVER_INDEX_VERSION "# stego cover index v1"
+#define COVER_NAME_SIZE 256
+#define COVER_INDEX_MAX_THREADS 8
+
+typedef struct _CoverEntry
+{
+    char name[COVER_NAME_SIZE];  // File name inside the indexed directory
+    uint width;                  // Width in pixels
+    uint height;                 // Height in pixels (absolute value)
+    uint bpp;                    // Bits per pixel
+    uint pixel_offset;           // Offset of the pixel array
+    unsigned long long capacity; // Cover bytes past the fixed header, 0 if not a usable cover
+    long long mtime;             // Modification time when the header was read
+    long long file_size;         // File size when the header was read
+} CoverEntry;
+
+typedef struct _CoverIndex
+{
+    const char *dir;     // Indexed directory
+    CoverEntry *entries; // Sorted by capacity, then name
+    uint count;          // Number of entries
+} CoverIndex;
+
+/* Load the index of dir, rescan new or changed covers and save it back */
+Status cover_index_update(const char *dir, CoverIndex *index);
+
+/* Smallest cover whose capacity is at least required, NULL if none */
+const CoverEntry *cover_index_best_fit(const CoverIndex *index, unsigned long long required);
+
+/* Release the entries of an index */
+void cover_index_free(CoverIndex *index);
+
+#endif
@@ -5,8 +5,18 @@ Date       :30/07/2025
 Description:Steganography project
 */
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
+#include "adaptive.h"
+#include "arena.h"
+#include "channels.h"
+#include "checksum.h"
 #include "decode.h"
+#include "journal.h"
+#include "matrix.h"
+#include "pipeline.h"
+#include "profile.h"
+#include "scan.h"
 #include "types.h"
 #include "common.h"
 
@@ -18,14 +28,26 @@ Status do_decoding(DecodeInfo *decInfo)
     printf("──────────────────────────────────────────────\n");
     printf("[INFO] Opening required files\n");
 
-    // Open stego image file
-    decInfo->fptr_stego_image = fopen(decInfo->stego_image_fname, "r");
+    // Open stego image file, or the BMP view of an image in another format
+    if (decInfo->stego_format != e_format_bmp)
+    {
+        decInfo->fptr_stego_image = adapter_open_read(decInfo->stego_image_fname, decInfo->stego_format, decInfo->raw_width, decInfo->raw_height, 0);
+    }
+    else
+    {
+        decInfo->fptr_stego_image = fopen(decInfo->stego_image_fname, "r");
+    }
     if (decInfo->fptr_stego_image == NULL)
     {
         fprintf(stderr, "ERROR: ❌ Failed to open stego image file: %s\n", decInfo->stego_image_fname);
         perror("ERROR");
         return e_failure;
     }
+    decInfo->io_buf = arena_alloc(ARENA_STDIO_BUF);
+    if (decInfo->io_buf != NULL)
+    {
+        setvbuf(decInfo->fptr_stego_image, decInfo->io_buf, _IOFBF, ARENA_STDIO_BUF);
+    }
     printf("[INFO] Opened %s\n", decInfo->stego_image_fname);
     printf("[INFO] ✅ Done\n\n");
 
@@ -38,6 +60,14 @@ Status do_decoding(DecodeInfo *decInfo)
     }
     printf("[INFO] ✅ Done\n\n");
 
+    // The pipeline reads the image file directly, not through the lane
+    if (decInfo->fptr_image_file != NULL && decInfo->pipeline)
+    {
+        printf("[INFO] Channel payloads are decoded stepwise; ignoring --pipeline\n");
+        decInfo->pipeline = 0;
+        decInfo->resume = 0;
+    }
+
     // Decode extension size of secret file
     printf("[INFO] Decoding Output File Extension size\n");
     if (decode_secret_file_extn_size(decInfo) == e_failure)
@@ -47,6 +77,13 @@ Status do_decoding(DecodeInfo *decInfo)
     }
     printf("[INFO] ✅ Done\n\n");
 
+    // Async jobs are cancelled and timed in the pipeline, which the lane and adaptive decoders bypass
+    if (decInfo->control != NULL && (decInfo->fptr_image_file != NULL || (decInfo->stego_flags & FLAG_ADAPTIVE)))
+    {
+        fprintf(stderr, "ERROR: ❌ Channel and adaptive payloads cannot be decoded as async jobs\n");
+        return e_failure;
+    }
+
     // Decode actual extension of secret file (e.g. .txt, .c, etc.)
     printf("[INFO] Decoding Output File Extension\n");
     if (decode_secret_file_extn(decInfo) == e_failure)
@@ -61,7 +98,11 @@ Status do_decoding(DecodeInfo *decInfo)
     printf("[INFO] Creating output file: %s\n", decInfo->secret_fname);
 
     // opening the secret file
-    decInfo->fptr_secret = fopen(decInfo->secret_fname, "w");
+    decInfo->fptr_secret = decInfo->resume ? fopen(decInfo->secret_fname, "r+") : NULL;
+    if (decInfo->fptr_secret == NULL)
+    {
+        decInfo->fptr_secret = fopen(decInfo->secret_fname, "w");
+    }
     if (decInfo->fptr_secret == NULL)
     {
         perror("fopen");
@@ -81,12 +122,92 @@ Status do_decoding(DecodeInfo *decInfo)
 
     // Decode and extract secret file data
     printf("[INFO] Decoding secret file content\n");
-    if (decode_secret_file_data(decInfo) == e_failure)
+    if (decInfo->stego_flags & FLAG_ADAPTIVE)
+    {
+        printf("[INFO] Secret data is in the textured regions\n");
+        if (decode_adaptive_data(decInfo) == e_failure)
+        {
+            fprintf(stderr, "Error: ❌ Failed at decoding file data\n");
+            return e_failure;
+        }
+    }
+    else if ((decInfo->pipeline ? decode_secret_file_data_pipelined(decInfo) : decode_secret_file_data(decInfo)) == e_failure)
     {
         fprintf(stderr, "Error: ❌ Failed at decoding file data\n");
         return e_failure;
     }
     printf("[INFO] ✅ Done\n\n");
+
+    // Check the data against its checksum when one was stored
+    if (decInfo->stego_flags & FLAG_CRC)
+    {
+        printf("[INFO] Verifying secret file checksum\n");
+        if (decode_secret_file_crc(decInfo) == e_failure)
+        {
+            fprintf(stderr, "Error: ❌ Secret file checksum mismatch\n");
+            return e_failure;
+        }
+        printf("[INFO] ✅ Done. CRC 0x%08x\n\n", decInfo->secret_crc);
+    }
+    return e_success;
+}
+
+// Strip --options from argv, compacting the remaining arguments
+Status read_decode_options(int *argc, char *argv[], DecodeInfo *decInfo)
+{
+    int i, j = 2;
+    decInfo->pipeline = 0;
+    decInfo->block_kb = profile_block_kb();
+    decInfo->control = NULL;
+    decInfo->resume = 0;
+    decInfo->checkpoint_mb = JOURNAL_DEFAULT_INTERVAL_MB;
+    decInfo->mem_mb = 0;
+    decInfo->raw_width = decInfo->raw_height = 0;
+
+    for (i = 2; i < *argc; i++)
+    {
+        if (strncmp(argv[i], "--", 2) != 0)
+        {
+            argv[j++] = argv[i];
+        }
+        else if (strcmp(argv[i], "--pipeline") == 0)
+        {
+            decInfo->pipeline = 1;
+        }
+        else if (strcmp(argv[i], "--resume") == 0)
+        {
+            decInfo->resume = 1;
+            decInfo->pipeline = 1;
+        }
+        else if (strncmp(argv[i], "--checkpoint-mb=", 16) == 0 && atoi(argv[i] + 16) > 0)
+        {
+            decInfo->checkpoint_mb = atoi(argv[i] + 16);
+        }
+        else if (strncmp(argv[i], "--block-kb=", 11) == 0 && atoi(argv[i] + 11) > 0 && atoi(argv[i] + 11) <= PIPELINE_MAX_BLOCK_KB)
+        {
+            decInfo->block_kb = atoi(argv[i] + 11);
+        }
+        else if (strncmp(argv[i], "--mem-mb=", 9) == 0 && atoi(argv[i] + 9) > 0)
+        {
+            decInfo->mem_mb = atoi(argv[i] + 9);
+            decInfo->pipeline = 1;
+        }
+        else if (strncmp(argv[i], "--raw-size=", 11) == 0)
+        {
+            if (parse_raw_size(argv[i] + 11, &decInfo->raw_width, &decInfo->raw_height) == e_failure)
+            {
+                printf("ERROR: ❌ --raw-size takes <width>x<height>\n");
+                return e_failure;
+            }
+        }
+        else
+        {
+            printf("ERROR: ❌ Unknown option %s\n", argv[i]);
+            return e_failure;
+        }
+    }
+    *argc = j;
+    argv[j] = NULL;
     return e_success;
 }
 
@@ -94,17 +215,24 @@ Status do_decoding(DecodeInfo *decInfo)
 Status read_and_validate_decode_args(char *argv[], DecodeInfo *decInfo)
 {
     decInfo->fptr_stego_image = NULL;
+    decInfo->fptr_image_file = NULL;
     decInfo->fptr_secret = NULL;
+    decInfo->io_buf = NULL;
 
-    // Validate input BMP file
-    char *bmp = strstr(argv[2], ".bmp");
-    if ((bmp != NULL) && strcmp(bmp, ".bmp") == 0)
+    // Validate input image file; other formats than BMP are read through an adapter
+    decInfo->stego_format = image_format(argv[2]);
+    if (decInfo->stego_format != e_format_unknown)
     {
         decInfo->stego_image_fname = argv[2];
     }
     else
     {
-        printf("Error: ❌ Enter file name with <file_name.bmp>\n");
+        printf("Error: ❌ Enter file name with <file_name.bmp|.ppm|.tga|.rgb|.raw>\n");
+        return e_failure;
+    }
+    if (decInfo->stego_format == e_format_raw && decInfo->raw_width == 0)
+    {
+        printf("Error: ❌ A raw RGB image needs --raw-size=<width>x<height>\n");
         return e_failure;
     }
 
@@ -127,10 +255,85 @@ Status read_and_validate_decode_args(char *argv[], DecodeInfo *decInfo)
     return e_success;
 }
 
-// Decode the magic string to verify data presence
+// Format flags of the header whose magic string was just read; the file position is kept
+static int peek_flags(DecodeInfo *decInfo)
+{
+    char buffer[32];
+    int field = 0;
+    long pos = ftell(decInfo->fptr_stego_image);
+
+    if (fread(buffer, 32, 1, decInfo->fptr_stego_image) == 1)
+    {
+        decode_int_from_lsb(&field, buffer);
+    }
+    fseek(decInfo->fptr_stego_image, pos, SEEK_SET);
+    return (uint)field >> FLAGS_SHIFT;
+}
+
+// Try every channel mask the pixel format allows; on a match the lane stands in for the image
+static Status decode_channel_magic(DecodeInfo *decInfo)
+{
+    FILE *image = decInfo->fptr_stego_image;
+    ChannelLayout layout;
+    char name[5];
+    int mask;
+
+    for (mask = 1; mask <= 0xF; mask++)
+    {
+        FILE *lane;
+        if (channel_layout(image, mask, &layout) == e_failure ||
+            layout.rows * layout.lane_row < (long long)strlen(MAGIC_STRING) * 8 + 32 ||
+            (lane = channel_open_lane(image, &layout)) == NULL)
+        {
+            continue;
+        }
+        decInfo->fptr_stego_image = lane;
+        if (decode_magic_string_at(decInfo, CHANNEL_LANE_BASE) == e_success)
+        {
+            int flags = peek_flags(decInfo);
+            if ((flags & FLAG_CHANNELS) && (flags & FLAG_CHANNEL_MASK) >> FLAG_CHANNEL_SHIFT == mask)
+            {
+                channel_mask_name(mask, name);
+                printf("[INFO] Found a payload in channels %s\n", name);
+                decInfo->fptr_image_file = image;
+                return e_success;
+            }
+        }
+        fclose(lane);
+        decInfo->fptr_stego_image = image;
+    }
+    return e_failure;
+}
+
+// Decode the magic string to verify data presence, scanning for it if it is not after the 54-byte header
 Status decode_magic_string(DecodeInfo *decInfo)
 {
-    fseek(decInfo->fptr_stego_image, 54, SEEK_SET); // Skip BMP header
+    long offset;
+
+    decInfo->payload_offset = 54;
+    if (decode_magic_string_at(decInfo, 54) == e_success && !(peek_flags(decInfo) & FLAG_CHANNELS))
+    {
+        return e_success;
+    }
+    // A channel payload keeps its header in the selected channels too
+    if (decode_channel_magic(decInfo) == e_success)
+    {
+        return e_success;
+    }
+    printf("[INFO] Magic string not found at byte 54, scanning the image\n");
+    if (scan_for_payload(decInfo->fptr_stego_image, (size_t)decInfo->mem_mb << 20, &offset) == e_failure)
+    {
+        return e_failure;
+    }
+    printf("[INFO] Found a payload at byte %ld\n", offset);
+    decInfo->payload_offset = offset;
+    return decode_magic_string_at(decInfo, offset);
+}
+
+// Decode the magic string starting at a byte offset
+Status decode_magic_string_at(DecodeInfo *decInfo, long offset)
+{
+    fseek(decInfo->fptr_stego_image, offset, SEEK_SET);
     int i;
     char buffer[8], ch, magicString[strlen(MAGIC_STRING) + 1];
     for (i = 0; i < strlen(MAGIC_STRING); i++)
@@ -177,6 +380,25 @@ Status decode_secret_file_extn_size(DecodeInfo *decInfo)
         return e_failure;
     }
     decode_int_from_lsb(&decInfo->secret_file_extn_size, buffer);
+
+    // Split off the format flags packed above the extension size
+    decInfo->stego_flags = (uint)decInfo->secret_file_extn_size >> FLAGS_SHIFT;
+    decInfo->secret_file_extn_size &= EXTN_SIZE_MASK;
+    if (decInfo->stego_flags & FLAG_MATRIX)
+    {
+        int k = (decInfo->stego_flags & FLAG_MATRIX_K_MASK) >> FLAG_MATRIX_K_SHIFT;
+        if (k < MATRIX_MIN_K || k > MATRIX_MAX_K)
+        {
+            printf("ERROR: ❌ Invalid matrix code parameter %d in %s\n", k, decInfo->stego_image_fname);
+            return e_failure;
+        }
+        printf("[INFO] Secret data is matrix embedded with k = %d\n", k);
+    }
+    if ((decInfo->stego_flags & FLAG_ADAPTIVE) && (decInfo->stego_flags & FLAG_MATRIX))
+    {
+        printf("ERROR: ❌ Invalid format flags 0x%x in %s\n", decInfo->stego_flags, decInfo->stego_image_fname);
+        return e_failure;
+    }
     return e_success;
 }
 
@@ -197,9 +419,16 @@ Status decode_int_from_lsb(int *size, char *image_buffer)
 // Decode and attach extension to the output file name
 Status decode_secret_file_extn(DecodeInfo *decInfo)
 {
-    char extension[decInfo->secret_file_extn_size + 1];
+    char extension[MAX_FILE_SUFFIX + 1];
     char buffer[8], ch;
     int i;
+
+    // The size comes from the image; anything longer than a known extension is not a payload
+    if (decInfo->secret_file_extn_size > MAX_FILE_SUFFIX)
+    {
+        printf("ERROR: ❌ Invalid extension size %d in %s\n", decInfo->secret_file_extn_size, decInfo->stego_image_fname);
+        return e_failure;
+    }
     for (i = 0; i < decInfo->secret_file_extn_size; i++)
     {
         if (fread(buffer, 8, 1, decInfo->fptr_stego_image) != 1)
@@ -235,6 +464,13 @@ Status decode_secret_file_data(DecodeInfo *decInfo)
 {
     char buffer[8], ch;
     int i;
+
+    decInfo->secret_crc = 0;
+    if (decInfo->stego_flags & FLAG_MATRIX)
+    {
+        int k = (decInfo->stego_flags & FLAG_MATRIX_K_MASK) >> FLAG_MATRIX_K_SHIFT;
+        return decode_matrix_data_from_image(decInfo->size_secret_file, k, decInfo->fptr_stego_image, decInfo->fptr_secret, &decInfo->secret_crc);
+    }
     for (i = 0; i < decInfo->size_secret_file; i++)
     {
         if (fread(buffer, 8, 1, decInfo->fptr_stego_image) != 1)
@@ -250,6 +486,26 @@ Status decode_secret_file_data(DecodeInfo *decInfo)
             printf("ERROR: ❌ Failed to write %s into %s decoding data\n", decInfo->stego_image_fname, decInfo->secret_fname);
             return e_failure;
         }
+        decInfo->secret_crc = crc32_update(decInfo->secret_crc, &ch, 1);
+    }
+    return e_success;
+}
+
+// Decode the stored CRC-32 and compare it with the one of the decoded data
+Status decode_secret_file_crc(DecodeInfo *decInfo)
+{
+    char buffer[32];
+    int crc;
+    if (fread(buffer, 32, 1, decInfo->fptr_stego_image) != 1)
+    {
+        printf("ERROR: ❌ Failed to read %s while decoding the checksum\n", decInfo->stego_image_fname);
+        return e_failure;
+    }
+    decode_int_from_lsb(&crc, buffer);
+    if ((uint)crc != decInfo->secret_crc)
+    {
+        printf("ERROR: ❌ Stored CRC 0x%08x, decoded data has 0x%08x\n", (uint)crc, decInfo->secret_crc);
+        return e_failure;
     }
     return e_success;
 }
@@ -262,6 +518,10 @@ void close_decode_files(DecodeInfo *decInfo)
     {
         flag = 1;
         fclose(decInfo->fptr_stego_image);
+        if (decInfo->fptr_image_file != NULL)
+        {
+            fclose(decInfo->fptr_image_file);
+        }
         printf("[INFO] Closing %s file\n", decInfo->stego_image_fname);
     }
 
@@ -271,6 +531,8 @@ void close_decode_files(DecodeInfo *decInfo)
         fclose(decInfo->fptr_secret);
         printf("[INFO] Closing %s file\n", decInfo->secret_fname);
     }
+    arena_free(decInfo->io_buf);
+    decInfo->io_buf = NULL;
     if (flag)
     {
         printf("[INFO] ✅ Done. Successfully closed files\n");
@@ -1,7 +1,8 @@
 #ifndef DECODE_H
-#define DeCODE_H
+#define DECODE_H
 
 #include <stdio.h>
+#include "adapter.h" // ImageFormat
 #include "types.h" // User-defined data types
 
 /*
@@ -20,14 +21,29 @@ typedef struct _DecodeInfo
     char *magic_string;                     // Expected magic string to validate presence of hidden data
     char secret_fname[50];                  // Output filename for the decoded secret
     FILE *fptr_secret;                      // File pointer to store decoded secret file
-    char extn_secret_file[MAX_FILE_SUFFIX]; // Extension of the secret file (e.g., .txt, .c)
+    char extn_secret_file[MAX_FILE_SUFFIX + 1]; // Extension of the secret file (e.g., .txt, .c)
 
     int secret_file_extn_size; // Length of secret file extension
+    int stego_flags;           // Format flags stored above the extension size
     int size_secret_file;      // Size of the decoded secret file
+    uint secret_crc;           // CRC-32 of the decoded secret file data
+    long payload_offset;       // Byte offset where the magic string starts
 
     /* Stego Image Info */
     char *stego_image_fname; // Name of the stego image (input)
     FILE *fptr_stego_image;  // File pointer to the stego image
+    ImageFormat stego_format; // BMP, or a format read through an adapter
+    uint raw_width, raw_height; // Frame size of a raw RGB image
+    FILE *fptr_image_file;   // The image itself while fptr_stego_image reads its channel lane, else NULL
+
+    /* Decode options */
+    int pipeline;  // Read, extract and write on separate threads
+    uint block_kb; // Pipeline block size
+    int resume;         // Continue from the output's checkpoint journal
+    uint checkpoint_mb; // Output MB between pipeline checkpoints
+    uint mem_mb;        // Memory budget for streaming and scanning the image, 0 for none
+    struct _JobControl *control; // Cancel, deadline and progress of an async job, else NULL
+    char *io_buf;                // Arena stdio buffer of the stego image
 
 } DecodeInfo;
 
@@ -36,6 +52,9 @@ typedef struct _DecodeInfo
 /* Identify the operation type (encode/decode) based on command-line arguments */
 OperationType check_operation_type(char *argv[]);
 
+/* Strip --options from argv and store them in decInfo */
+Status read_decode_options(int *argc, char *argv[], DecodeInfo *decInfo);
+
 /* Read and validate decoding arguments from command line */
 Status read_and_validate_decode_args(char *argv[], DecodeInfo *decInfo);
 
@@ -45,6 +64,9 @@ Status do_decoding(DecodeInfo *decInfo);
 /* Decode the magic string from the stego image and verify it */
 Status decode_magic_string(DecodeInfo *decInfo);
 
+/* Decode and verify the magic string at a given byte offset */
+Status decode_magic_string_at(DecodeInfo *decInfo, long offset);
+
 /* Decode the size of the secret file extension from the stego image */
 Status decode_secret_file_extn_size(DecodeInfo *decInfo);
 
@@ -60,6 +82,9 @@ Status decode_secret_file_size(DecodeInfo *decInfo);
 /* Decode the secret file data (content) from the stego image */
 Status decode_secret_file_data(DecodeInfo *decInfo);
 
+/* Decode the checksum trailer and compare it with the decoded data */
+Status decode_secret_file_crc(DecodeInfo *decInfo);
+
 /* Decode a single byte from the LSBs of 8 bytes in the image buffer */
 Status decode_byte_from_lsb(char *ch, char *buffer);
 
@@ -5,6 +5,9 @@ Date       :30/07/2025
 Description:Steganography project
 */
 #include <stdio.h>
+#include <stdlib.h>
+#include "adapter.h"
+#include "arena.h"
 #include "encode.h"
 #include "types.h"
 #include "common.h"
@@ -15,11 +18,13 @@ Description:Steganography project
  * Input: Image file ptr
  * Output: width * height * bytes per pixel (3 in our case)
  * Description: In BMP Image, width is stored in offset 18,
- * and height after that. size is 4 bytes
+ * and height after that. size is 4 bytes. Height is negative
+ * for top-down images, and gigapixel images overflow 32 bits,
+ * so the product is taken in 64 bits.
  */
-uint get_image_size_for_bmp(FILE *fptr_image)
+unsigned long long get_image_size_for_bmp(FILE *fptr_image)
 {
-    uint width, height;
+    int width, height;
     // Seek to 18th byte
     fseek(fptr_image, 18, SEEK_SET);
 
@@ -35,7 +40,7 @@ uint get_image_size_for_bmp(FILE *fptr_image)
     // printf("height = %u\n", height);
 
     // Return image capacity
-    return width * height * 3;
+    return (unsigned long long)llabs(width) * llabs(height) * 3;
 }
 
 /*
@@ -47,8 +52,16 @@ uint get_image_size_for_bmp(FILE *fptr_image)
  */
 Status open_files(EncodeInfo *encInfo)
 {
-    // Src Image file
-    encInfo->fptr_src_image = fopen(encInfo->src_image_fname, "r");
+    // Src Image file, or the BMP view of a cover in another format
+    if (encInfo->src_format != e_format_bmp)
+    {
+        encInfo->fptr_src_image = adapter_open_read(encInfo->src_image_fname, encInfo->src_format, encInfo->raw_width, encInfo->raw_height,
+                                                   encInfo->stego_format == e_format_bmp);
+    }
+    else
+    {
+        encInfo->fptr_src_image = fopen(encInfo->src_image_fname, "r");
+    }
     // Do Error handling
     if (encInfo->fptr_src_image == NULL)
     {
@@ -57,6 +70,11 @@ Status open_files(EncodeInfo *encInfo)
 
         return e_failure;
     }
+    encInfo->io_buf[0] = arena_alloc(ARENA_STDIO_BUF);
+    if (encInfo->io_buf[0] != NULL)
+    {
+        setvbuf(encInfo->fptr_src_image, encInfo->io_buf[0], _IOFBF, ARENA_STDIO_BUF);
+    }
 
     // Secret file
     encInfo->fptr_secret = fopen(encInfo->secret_fname, "r");
@@ -69,8 +87,21 @@ Status open_files(EncodeInfo *encInfo)
         return e_failure;
     }
 
-    // Stego Image file
-    encInfo->fptr_stego_image = fopen(encInfo->stego_image_fname, "w");
+    // Stego Image file; a resumed job keeps what was already written
+    encInfo->fptr_stego_image = NULL;
+    if (encInfo->resume)
+    {
+        encInfo->fptr_stego_image = fopen(encInfo->stego_image_fname, "r+");
+    }
+    if (encInfo->fptr_stego_image == NULL && encInfo->stego_format != e_format_bmp)
+    {
+        encInfo->fptr_stego_image = adapter_open_write(encInfo->stego_image_fname, encInfo->src_image_fname,
+                                                       encInfo->stego_format, encInfo->raw_width, encInfo->raw_height);
+    }
+    else if (encInfo->fptr_stego_image == NULL)
+    {
+        encInfo->fptr_stego_image = fopen(encInfo->stego_image_fname, "w");
+    }
     // Do Error handling
     if (encInfo->fptr_stego_image == NULL)
     {
@@ -79,6 +110,11 @@ Status open_files(EncodeInfo *encInfo)
 
         return e_failure;
     }
+    encInfo->io_buf[1] = arena_alloc(ARENA_STDIO_BUF);
+    if (encInfo->io_buf[1] != NULL)
+    {
+        setvbuf(encInfo->fptr_stego_image, encInfo->io_buf[1], _IOFBF, ARENA_STDIO_BUF);
+    }
 
     // No failure return e_success
     return e_success;
@@ -111,6 +147,11 @@ void close_encode_files(EncodeInfo *encInfo)
         printf("[INFO] Closing %s file\n", encInfo->secret_fname);
     }
 
+    // The stdio buffers outlive their streams until here
+    arena_free(encInfo->io_buf[0]);
+    arena_free(encInfo->io_buf[1]);
+    encInfo->io_buf[0] = encInfo->io_buf[1] = NULL;
+
     // Print success message if any file was closed
     if (flag)
     {
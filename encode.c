@@ -5,14 +5,36 @@ Date       :30/07/2025
 Description:Steganography project
 */
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
+#include <sys/stat.h>
+#include "adaptive.h"
+#include "arena.h"
+#include "cache.h"
+#include "channels.h"
+#include "checksum.h"
 #include "common.h"
+#include "cover_index.h"
+#include "decode.h"
 #include "encode.h"
+#include "journal.h"
+#include "matrix.h"
+#include "pipeline.h"
+#include "profile.h"
+#include "update.h"
 #include "types.h"
 
+static Status report_verify(EncodeInfo *encInfo);
+
 // Main encoding function that performs all encoding steps
 Status do_encoding(EncodeInfo *encInfo)
 {
+    // Patching an existing stego image touches only the changed regions
+    if (encInfo->update_mode != UPDATE_NONE)
+    {
+        return do_update(encInfo);
+    }
+
     printf("[INFO] Opening requried files\n");
     if ((open_files(encInfo)) == e_failure)
     {
@@ -47,6 +69,21 @@ Status do_encoding(EncodeInfo *encInfo)
     }
     printf("[INFO] ✅ Done\n\n");
 
+    // Header, data and checksum all go into the selected channels
+    if (encInfo->channels)
+    {
+        char name[5];
+        channel_mask_name(encInfo->channels, name);
+        printf("[INFO] Encoding %s into channels %s\n", encInfo->secret_fname, name);
+        if (encode_channel_data(encInfo) == e_failure)
+        {
+            fprintf(stderr, "ERROR: ❌ Failed to encode secret file data\n");
+            return e_failure;
+        }
+        printf("[INFO] ✅ Done\n\n");
+        return report_verify(encInfo);
+    }
+
     // Encode magic string
     printf("[INFO] Encoding Magic String Signature\n");
     if (encode_magic_string(MAGIC_STRING, encInfo) == e_failure)
@@ -58,7 +95,7 @@ Status do_encoding(EncodeInfo *encInfo)
 
     // Encode secret file extension size
     printf("[INFO] Encoding %s File Extension Size\n", encInfo->secret_fname);
-    if (encode_secret_file_extn_size(strlen(encInfo->extn_secret_file), encInfo) == e_failure)
+    if (encode_secret_file_extn_size(strlen(encInfo->extn_secret_file) | (get_encode_flags(encInfo) << FLAGS_SHIFT), encInfo) == e_failure)
     {
         printf("ERROR: ❌ Failed to encode file extension size\n");
         return e_failure;
@@ -83,6 +120,32 @@ Status do_encoding(EncodeInfo *encInfo)
     }
     printf("[INFO] ✅ Done\n\n");
 
+    // Checksum, data in the textured bytes and left over image data in one pass
+    if (encInfo->adaptive)
+    {
+        printf("[INFO] Encoding %s File Data into textured regions\n", encInfo->secret_fname);
+        if (encode_adaptive_data(encInfo) == e_failure)
+        {
+            fprintf(stderr, "ERROR: ❌ Failed to encode secret file data\n");
+            return e_failure;
+        }
+        printf("[INFO] ✅ Done\n\n");
+        return report_verify(encInfo);
+    }
+
+    // Data, checksum and left over image data in one pass through the pipeline
+    if (encInfo->pipeline)
+    {
+        printf("[INFO] Encoding %s File Data through the pipeline\n", encInfo->secret_fname);
+        if (encode_secret_file_data_pipelined(encInfo) == e_failure)
+        {
+            fprintf(stderr, "ERROR: ❌ Failed to encode secret file data\n");
+            return e_failure;
+        }
+        printf("[INFO] ✅ Done\n\n");
+        return report_verify(encInfo);
+    }
+
     // Encode actual file data
     printf("[INFO] Encoding %s File Data\n", encInfo->secret_fname);
     if (encode_secret_file_data(encInfo) == e_failure)
@@ -92,6 +155,18 @@ Status do_encoding(EncodeInfo *encInfo)
     }
     printf("[INFO] ✅ Done\n\n");
 
+    // Checksum trailer for decoders and later updates
+    if (encInfo->verify)
+    {
+        printf("[INFO] Encoding %s Checksum\n", encInfo->secret_fname);
+        if (encode_secret_file_crc(encInfo) == e_failure)
+        {
+            printf("ERROR: ❌ Failed to encode secret file checksum\n");
+            return e_failure;
+        }
+        printf("[INFO] ✅ Done\n\n");
+    }
+
     // Copy remaining image data
     printf("[INFO] Copying Left Over Data\n");
     if (copy_remaining_img_data(encInfo->fptr_src_image, encInfo->fptr_stego_image) == e_failure)
@@ -101,6 +176,24 @@ Status do_encoding(EncodeInfo *encInfo)
     }
     printf("[INFO] ✅ Done\n\n");
 
+    return report_verify(encInfo);
+}
+
+// Everything was re-extracted before it was written; report the verdict
+static Status report_verify(EncodeInfo *encInfo)
+{
+    if (encInfo->verify)
+    {
+        printf("[INFO] Verifying round trip\n");
+        if (verify_result(&encInfo->verify_info) == e_failure)
+        {
+            printf("ERROR: ❌ Verification failed: %u mismatched bytes, CRC 0x%08x != 0x%08x\n",
+                   encInfo->verify_info.mismatches, encInfo->verify_info.out_crc, encInfo->verify_info.src_crc);
+            return e_failure;
+        }
+        printf("[INFO] ✅ Verified %llu bytes, CRC 0x%08x\n\n", encInfo->verify_info.bytes, encInfo->verify_info.src_crc);
+    }
+
     return e_success;
 }
 
@@ -115,49 +208,256 @@ OperationType check_operation_type(char *argv[])
     {
         return e_decode;
     }
+    else if (strcmp(argv[1], "-i") == 0)
+    {
+        return e_index;
+    }
+    else if (strcmp(argv[1], "-f") == 0)
+    {
+        return e_fanout;
+    }
+    else if (strcmp(argv[1], "-t") == 0 || strcmp(argv[1], "tune") == 0)
+    {
+        return e_tune;
+    }
+    else if (strcmp(argv[1], "-w") == 0 || strcmp(argv[1], "watch") == 0)
+    {
+        return e_watch;
+    }
     else
     {
         return e_unsupported;
     }
 }
 
-// Validate and read encoding arguments
-Status read_and_validate_encode_args(char *argv[], EncodeInfo *encInfo)
+// Strip --options from argv, leaving the positional arguments in place
+Status read_encode_options(int *argc, char *argv[], EncodeInfo *encInfo)
 {
-    encInfo->fptr_src_image = NULL;
-    encInfo->fptr_stego_image = NULL;
-    encInfo->fptr_secret = NULL;
+    int i, j = 2;
+    encInfo->matrix_k = 0;
+    encInfo->auto_cover_dir = NULL;
+    encInfo->verify = 0;
+    encInfo->update_mode = UPDATE_NONE;
+    encInfo->cache_dir = getenv(CACHE_ENV_DIR);
+    encInfo->cache_max_mb = CACHE_DEFAULT_MAX_MB;
+    encInfo->cache_key[0] = '\0';
+    encInfo->pipeline = 0;
+    encInfo->adaptive = 0;
+    encInfo->channels = 0;
+    encInfo->resume = 0;
+    encInfo->checkpoint_mb = JOURNAL_DEFAULT_INTERVAL_MB;
+    encInfo->block_kb = profile_block_kb();
+    encInfo->mem_mb = 0;
+    encInfo->raw_width = encInfo->raw_height = 0;
+    encInfo->src_format = encInfo->stego_format = e_format_bmp;
+    encInfo->control = NULL;
+    encInfo->io_buf[0] = encInfo->io_buf[1] = NULL;
+    verify_init(&encInfo->verify_info);
 
-    // Check source image file extension
-    char *bmp = strstr(argv[2], ".bmp");
-    if ((bmp != NULL) && (strcmp(bmp, ".bmp") == 0))
+    for (i = 2; i < *argc; i++)
     {
-        encInfo->src_image_fname = argv[2];
+        if (strncmp(argv[i], "--", 2) != 0)
+        {
+            argv[j++] = argv[i];
+        }
+        else if (strcmp(argv[i], "--matrix") == 0)
+        {
+            encInfo->matrix_k = MATRIX_AUTO;
+        }
+        else if (strncmp(argv[i], "--matrix=", 9) == 0)
+        {
+            encInfo->matrix_k = atoi(argv[i] + 9);
+            if (encInfo->matrix_k < MATRIX_MIN_K || encInfo->matrix_k > MATRIX_MAX_K)
+            {
+                printf("ERROR: ❌ Matrix code parameter must be between %d and %d\n", MATRIX_MIN_K, MATRIX_MAX_K);
+                return e_failure;
+            }
+        }
+        else if (strcmp(argv[i], "--verify") == 0)
+        {
+            encInfo->verify = 1;
+        }
+        else if (strcmp(argv[i], "--append") == 0)
+        {
+            encInfo->update_mode = UPDATE_APPEND;
+        }
+        else if (strcmp(argv[i], "--update") == 0)
+        {
+            encInfo->update_mode = UPDATE_REPLACE;
+        }
+        else if (strncmp(argv[i], "--cache=", 8) == 0 && argv[i][8] != '\0')
+        {
+            encInfo->cache_dir = argv[i] + 8;
+        }
+        else if (strncmp(argv[i], "--cache-max-mb=", 15) == 0 && atoi(argv[i] + 15) > 0)
+        {
+            encInfo->cache_max_mb = atoi(argv[i] + 15);
+        }
+        else if (strncmp(argv[i], "--auto-cover=", 13) == 0 && argv[i][13] != '\0')
+        {
+            encInfo->auto_cover_dir = argv[i] + 13;
+        }
+        else if (strcmp(argv[i], "--pipeline") == 0)
+        {
+            encInfo->pipeline = 1;
+        }
+        else if (strcmp(argv[i], "--adaptive") == 0)
+        {
+            encInfo->adaptive = 1;
+        }
+        else if (strncmp(argv[i], "--channels=", 11) == 0)
+        {
+            encInfo->channels = channel_parse_mask(argv[i] + 11);
+            if (encInfo->channels == 0)
+            {
+                printf("ERROR: ❌ --channels takes letters from B, G, R and A\n");
+                return e_failure;
+            }
+        }
+        else if (strcmp(argv[i], "--resume") == 0)
+        {
+            // Checkpoints are taken by the pipeline
+            encInfo->resume = 1;
+            encInfo->pipeline = 1;
+        }
+        else if (strncmp(argv[i], "--checkpoint-mb=", 16) == 0 && atoi(argv[i] + 16) > 0)
+        {
+            encInfo->checkpoint_mb = atoi(argv[i] + 16);
+        }
+        else if (strncmp(argv[i], "--block-kb=", 11) == 0 && atoi(argv[i] + 11) > 0 && atoi(argv[i] + 11) <= PIPELINE_MAX_BLOCK_KB)
+        {
+            encInfo->block_kb = atoi(argv[i] + 11);
+        }
+        else if (strncmp(argv[i], "--mem-mb=", 9) == 0 && atoi(argv[i] + 9) > 0)
+        {
+            // A bounded cover window needs the streaming pipeline
+            encInfo->mem_mb = atoi(argv[i] + 9);
+            encInfo->pipeline = 1;
+        }
+        else if (strncmp(argv[i], "--raw-size=", 11) == 0)
+        {
+            if (parse_raw_size(argv[i] + 11, &encInfo->raw_width, &encInfo->raw_height) == e_failure)
+            {
+                printf("ERROR: ❌ --raw-size takes <width>x<height>\n");
+                return e_failure;
+            }
+        }
+        else
+        {
+            printf("ERROR: ❌ Unknown option %s\n", argv[i]);
+            return e_failure;
+        }
     }
-    else
+    *argc = j;
+    argv[j] = NULL;
+
+    // In-place updates have no reproducible output to cache
+    if (encInfo->update_mode != UPDATE_NONE)
     {
-        printf("ERROR: ❌ Invalid source image name\n");
-        printf("[INFO] Source image must have a .bmp extension\n");
+        encInfo->cache_dir = NULL;
+    }
+
+    // The payload format of an existing image is kept as it is
+    if (encInfo->update_mode != UPDATE_NONE && (encInfo->matrix_k != 0 || encInfo->auto_cover_dir != NULL))
+    {
+        printf("ERROR: ❌ --append/--update cannot be combined with --matrix or --auto-cover\n");
         return e_failure;
     }
 
-    // Check secret file extension
-    char *sh = strstr(argv[3], ".sh");
-    char *txt = strstr(argv[3], ".txt");
-    char *c = strstr(argv[3], ".c");
+    // The selected bytes come from a whole-image pass of their own
+    if (encInfo->adaptive && (encInfo->matrix_k != 0 || encInfo->pipeline || encInfo->update_mode != UPDATE_NONE))
+    {
+        printf("ERROR: ❌ --adaptive cannot be combined with --matrix, --pipeline, --append or --update\n");
+        return e_failure;
+    }
+
+    // The lane is gathered and scattered in a streaming pass of its own
+    if (encInfo->channels && (encInfo->adaptive || encInfo->pipeline || encInfo->update_mode != UPDATE_NONE))
+    {
+        printf("ERROR: ❌ --channels cannot be combined with --adaptive, --pipeline, --mem-mb, --resume, --append or --update\n");
+        return e_failure;
+    }
+    return e_success;
+}
+
+// Look up the best-fit cover for the secret and insert it as argv[2]
+Status select_auto_cover(int *argc, char *argv[], EncodeInfo *encInfo)
+{
+    CoverIndex index;
+    struct stat st;
+    int i;
+
+    if (*argc < 3 || stat(argv[2], &st) != 0)
+    {
+        printf("ERROR: ❌ Unable to stat secret file %s\n", *argc < 3 ? "" : argv[2]);
+        return e_failure;
+    }
+    // The index is sorted on what each cover leaves past the fixed header; the least matrix k is the least need
+    char *extn = strrchr(argv[2], '.');
+    int k = encInfo->matrix_k == MATRIX_AUTO ? MATRIX_MIN_K : encInfo->matrix_k;
+    unsigned long long required = payload_cover_need(encInfo, extn ? strlen(extn) : 0, st.st_size, k);
+    if (encInfo->channels)
+    {
+        // The lane holds c of every 3 pixel bytes the index counts, after the same 54 bytes of header
+        unsigned long long fixed = HEADER_FIXED_SIZE - CHANNEL_LANE_BASE;
+        int c, lanes = 0;
+        for (c = encInfo->channels; c != 0; c >>= 1)
+        {
+            lanes += c & 1;
+        }
+        required = 3 * ((required + fixed + lanes - 1) / lanes) - HEADER_FIXED_SIZE;
+    }
+
+    if (cover_index_update(encInfo->auto_cover_dir, &index) == e_failure)
+    {
+        return e_failure;
+    }
+    const CoverEntry *entry = cover_index_best_fit(&index, required);
+    // Channel lanes need a 24 bpp cover, or 32 bpp for alpha; skip the larger covers that lack them
+    while (encInfo->channels && entry != NULL && entry->bpp != 32 && (entry->bpp != 24 || (encInfo->channels & CHANNEL_A)))
+    {
+        entry = entry + 1 < index.entries + index.count ? entry + 1 : NULL;
+    }
+    if (entry == NULL)
+    {
+        printf("ERROR: ❌ No cover in %s can hold %s\n", encInfo->auto_cover_dir, argv[2]);
+        cover_index_free(&index);
+        return e_failure;
+    }
+    snprintf(encInfo->auto_cover_fname, sizeof(encInfo->auto_cover_fname), "%s/%s", encInfo->auto_cover_dir, entry->name);
+    printf("[INFO] Auto-selected cover %s (capacity %llu, need %llu)\n", encInfo->auto_cover_fname, entry->capacity, required);
+    cover_index_free(&index);
+
+    // The option slot removed from argv leaves room for the cover argument
+    for (i = *argc; i > 2; i--)
+    {
+        argv[i] = argv[i - 1];
+    }
+    argv[2] = encInfo->auto_cover_fname;
+    (*argc)++;
+    argv[*argc] = NULL;
+    return e_success;
+}
+
+// Accept .c, .txt and .sh secret files and remember the extension
+Status validate_secret_fname(char *fname, EncodeInfo *encInfo)
+{
+    char *sh = strstr(fname, ".sh");
+    char *txt = strstr(fname, ".txt");
+    char *c = strstr(fname, ".c");
     if ((c != NULL) && (strcmp(c, ".c") == 0))
     {
-        encInfo->secret_fname = argv[3];
+        encInfo->secret_fname = fname;
         strcpy(encInfo->extn_secret_file, ".c");
     }
     else if ((txt != NULL) && (strcmp(txt, ".txt") == 0))
     {
-        encInfo->secret_fname = argv[3];
+        encInfo->secret_fname = fname;
         strcpy(encInfo->extn_secret_file, ".txt");
     }
     else if ((sh != NULL) && (strcmp(sh, ".sh") == 0))
     {
-        encInfo->secret_fname = argv[3];
+        encInfo->secret_fname = fname;
         strcpy(encInfo->extn_secret_file, ".sh");
     }
     else
@@ -166,6 +466,60 @@ Status read_and_validate_encode_args(char *argv[], EncodeInfo *encInfo)
         printf("[INFO] Secret file must have .c, .txt, or .sh extension\n");
         return e_failure;
     }
+    return e_success;
+}
+
+// Validate and read encoding arguments
+Status read_and_validate_encode_args(char *argv[], EncodeInfo *encInfo)
+{
+    encInfo->fptr_src_image = NULL;
+    encInfo->fptr_stego_image = NULL;
+    encInfo->fptr_secret = NULL;
+    encInfo->io_buf[0] = encInfo->io_buf[1] = NULL;
+
+    // Check source image file extension; other formats are read through an adapter
+    encInfo->src_format = image_format(argv[2]);
+    encInfo->stego_format = e_format_bmp;
+    if (encInfo->src_format != e_format_unknown)
+    {
+        encInfo->src_image_fname = argv[2];
+    }
+    else
+    {
+        printf("ERROR: ❌ Invalid source image name\n");
+        printf("[INFO] Source image must have a .bmp, .ppm, .tga, .rgb or .raw extension\n");
+        return e_failure;
+    }
+    if (encInfo->src_format == e_format_raw && encInfo->raw_width == 0)
+    {
+        printf("ERROR: ❌ A raw RGB cover needs --raw-size=<width>x<height>\n");
+        return e_failure;
+    }
+    // Adapted covers have no file descriptor to map or pread
+    if (encInfo->src_format != e_format_bmp &&
+        (encInfo->update_mode != UPDATE_NONE || encInfo->adaptive || encInfo->channels))
+    {
+        printf("ERROR: ❌ --append, --update, --adaptive and --channels need a BMP image\n");
+        return e_failure;
+    }
+
+    // Check secret file extension
+    if (validate_secret_fname(argv[3], encInfo) == e_failure)
+    {
+        return e_failure;
+    }
+
+    // Append/update rewrites the given stego image itself
+    if (encInfo->update_mode != UPDATE_NONE)
+    {
+        if (argv[4] != NULL)
+        {
+            printf("ERROR: ❌ %s is updated in place; no output image is needed\n", argv[2]);
+            return e_failure;
+        }
+        encInfo->stego_image_fname = argv[2];
+        return e_success;
+    }
 
     // Optional stego image name
     if (argv[4] == NULL)
@@ -175,28 +529,96 @@ Status read_and_validate_encode_args(char *argv[], EncodeInfo *encInfo)
     }
     else
     {
-        char *bmp2 = strstr(argv[4], ".bmp");
-        if ((bmp2 != NULL) && (strcmp(bmp, ".bmp") == 0))
+        // A BMP, or the cover's own format
+        encInfo->stego_format = image_format(argv[4]);
+        if (encInfo->stego_format == e_format_bmp || encInfo->stego_format == encInfo->src_format)
         {
             encInfo->stego_image_fname = argv[4];
         }
         else
         {
-            printf("ERROR: ❌ %s must contain the .bmp extension\n", argv[4]);
+            printf("ERROR: ❌ %s must have the .bmp extension or that of %s\n", argv[4], argv[2]);
             return e_failure;
         }
     }
+
+    // The checkpoint journal truncates and syncs the output by descriptor
+    if (encInfo->resume && encInfo->stego_format != e_format_bmp)
+    {
+        printf("ERROR: ❌ --resume needs a BMP output image\n");
+        return e_failure;
+    }
     return e_success;
 }
 
+// Cover bytes left for the extension and data once the fixed header is taken
+unsigned long long cover_payload_capacity(unsigned long long image_capacity)
+{
+    return image_capacity > HEADER_FIXED_SIZE ? image_capacity - HEADER_FIXED_SIZE : 0;
+}
+
+// Cover bytes past the fixed header a payload needs; check_capacity and the cover index both use it
+unsigned long long payload_cover_need(EncodeInfo *encInfo, uint extn_size, uint file_size, int k)
+{
+    unsigned long long need = extn_size * 8ULL + (encInfo->verify ? 32 : 0);
+    if (k != 0)
+    {
+        return need + matrix_cover_bytes(k, file_size);
+    }
+    // Plain LSB has always left one cover byte spare
+    return need + (unsigned long long)file_size * 8 + 1;
+}
+
 // Check if the image has enough capacity
 Status check_capacity(EncodeInfo *encInfo)
 {
-    encInfo->image_capacity = get_image_size_for_bmp(encInfo->fptr_src_image);
-    int encode_size = 54 + ((strlen(MAGIC_STRING) + 4 + strlen(encInfo->extn_secret_file) +
-                             4 + get_file_size(encInfo->fptr_secret)) *
-                            8);
-    if (encInfo->image_capacity > encode_size)
+    if (encInfo->channels)
+    {
+        // Only the lane of selected channels carries the payload
+        ChannelLayout layout;
+        if (channel_layout(encInfo->fptr_src_image, encInfo->channels, &layout) == e_failure)
+        {
+            printf("ERROR: ❌ %s is not a 24 bpp (B, G, R) or 32 bpp (B, G, R, A) image with those channels\n", encInfo->src_image_fname);
+            return e_failure;
+        }
+        encInfo->image_capacity = CHANNEL_LANE_BASE + layout.rows * layout.lane_row;
+    }
+    else
+    {
+        encInfo->image_capacity = get_image_size_for_bmp(encInfo->fptr_src_image);
+    }
+    unsigned long long header_size = 54 + (strlen(MAGIC_STRING) + 4 + strlen(encInfo->extn_secret_file) + 4) * 8;
+    if (encInfo->verify)
+    {
+        header_size += 32; // Checksum trailer
+    }
+    long long file_size = get_file_size(encInfo->fptr_secret);
+    if (file_size < 0 || file_size > MAX_SECRET_SIZE)
+    {
+        printf("ERROR: ❌ Secret file is larger than the %d bytes the size field can describe\n", MAX_SECRET_SIZE);
+        return e_failure;
+    }
+
+    if (encInfo->matrix_k != 0)
+    {
+        // Matrix groups must fit in what the header leaves over
+        unsigned long long avail = encInfo->image_capacity > header_size ? encInfo->image_capacity - header_size : 0;
+        int k = matrix_choose_k(avail, file_size);
+        if (k == 0 || (encInfo->matrix_k != MATRIX_AUTO && encInfo->matrix_k > k))
+        {
+            return e_failure;
+        }
+        if (encInfo->matrix_k == MATRIX_AUTO)
+        {
+            encInfo->matrix_k = k;
+        }
+        printf("[INFO] Using matrix embedding with k = %d (%d cover bytes per %d bits)\n",
+               encInfo->matrix_k, MATRIX_GROUP_SIZE(encInfo->matrix_k), encInfo->matrix_k);
+        return e_success;
+    }
+
+    unsigned long long avail = cover_payload_capacity(encInfo->image_capacity);
+    if (avail >= payload_cover_need(encInfo, strlen(encInfo->extn_secret_file), file_size, 0))
     {
         return e_success;
     }
@@ -204,11 +626,34 @@ Status check_capacity(EncodeInfo *encInfo)
         return e_failure;
 }
 
+// Collect the format flags for the chosen encode options
+int get_encode_flags(EncodeInfo *encInfo)
+{
+    int flags = 0;
+    if (encInfo->matrix_k > 0)
+    {
+        flags |= FLAG_MATRIX | (encInfo->matrix_k << FLAG_MATRIX_K_SHIFT);
+    }
+    if (encInfo->verify)
+    {
+        flags |= FLAG_CRC;
+    }
+    if (encInfo->adaptive)
+    {
+        flags |= FLAG_ADAPTIVE;
+    }
+    if (encInfo->channels)
+    {
+        flags |= FLAG_CHANNELS | (encInfo->channels << FLAG_CHANNEL_SHIFT);
+    }
+    return flags;
+}
+
 // Get the size of a file
-uint get_file_size(FILE *fptr)
+long long get_file_size(FILE *fptr)
 {
-    fseek(fptr, 0, SEEK_END);
-    return ftell(fptr);
+    fseeko(fptr, 0, SEEK_END);
+    return ftello(fptr);
 }
 
 // Copy the 54-byte BMP header
@@ -232,13 +677,37 @@ Status copy_bmp_header(FILE *fptr_src_image, FILE *fptr_dest_image)
 // Encode the predefined magic string
 Status encode_magic_string(const char *magic_string, EncodeInfo *encInfo)
 {
-    if (encode_data_to_image(magic_string, strlen(magic_string), encInfo->fptr_src_image, encInfo->fptr_stego_image) == e_success)
+    if (encode_data_to_image(magic_string, strlen(magic_string), encInfo->fptr_src_image, encInfo->fptr_stego_image, get_verify_info(encInfo)) == e_success)
         return e_success;
     return e_failure;
 }
 
+// Verify state to pass down, NULL when --verify is off
+VerifyInfo *get_verify_info(EncodeInfo *encInfo)
+{
+    return encInfo->verify ? &encInfo->verify_info : NULL;
+}
+
+// Re-extract an encoded 32-bit integer window and check it
+static void verify_int_window(EncodeInfo *encInfo, int data, char *buffer)
+{
+    int extracted;
+    char expected[4], actual[4];
+    if (!encInfo->verify)
+    {
+        return;
+    }
+    decode_int_from_lsb(&extracted, buffer);
+    for (int i = 0; i < 4; i++)
+    {
+        expected[i] = (data >> (24 - 8 * i)) & 0xFF;
+        actual[i] = (extracted >> (24 - 8 * i)) & 0xFF;
+    }
+    verify_window(&encInfo->verify_info, expected, actual, 4);
+}
+
 // Generic function to encode a string of data into image
-Status encode_data_to_image(const char *data, int size, FILE *fptr_src_image, FILE *fptr_stego_image)
+Status encode_data_to_image(const char *data, int size, FILE *fptr_src_image, FILE *fptr_stego_image, VerifyInfo *verify)
 {
     char buffer[8];
     for (int i = 0; i < size; i++)
@@ -249,6 +718,12 @@ Status encode_data_to_image(const char *data, int size, FILE *fptr_src_image, FI
             return e_failure;
         }
         encode_byte_to_lsb(data[i], buffer);
+        if (verify != NULL)
+        {
+            char ch;
+            decode_byte_from_lsb(&ch, buffer);
+            verify_window(verify, &data[i], &ch, 1);
+        }
         if (fwrite(buffer, 8, 1, fptr_stego_image) != 1)
         {
             fprintf(stderr, "ERROR: ❌ Failed to write encoded data to destination image\n");
@@ -282,6 +757,7 @@ Status encode_secret_file_extn_size(int extn_size, EncodeInfo *encInfo)
         return e_failure;
     }
     encode_int_to_lsb(extn_size, buffer);
+    verify_int_window(encInfo, extn_size, buffer);
     if (fwrite(buffer, 32, 1, encInfo->fptr_stego_image) != 1)
     {
         fprintf(stderr, "ERROR: ❌ Failed to write 32 bytes to the stego image after encoding extension size.\n");
@@ -307,7 +783,7 @@ Status encode_int_to_lsb(int data, char *image_buffer)
 // Encode the actual secret file extension
 Status encode_secret_file_extn(const char *file_extn, EncodeInfo *encInfo)
 {
-    if (encode_data_to_image(file_extn, strlen(file_extn), encInfo->fptr_src_image, encInfo->fptr_stego_image) == e_success)
+    if (encode_data_to_image(file_extn, strlen(file_extn), encInfo->fptr_src_image, encInfo->fptr_stego_image, get_verify_info(encInfo)) == e_success)
         return e_success;
     return e_failure;
 }
@@ -323,6 +799,7 @@ Status encode_secret_file_size(int file_size, EncodeInfo *encInfo)
         return e_failure;
     }
     encode_int_to_lsb(file_size, buffer);
+    verify_int_window(encInfo, file_size, buffer);
     if (fwrite(buffer, 32, 1, encInfo->fptr_stego_image) != 1)
     {
         fprintf(stderr, "ERROR: ❌ Failed to write encoded data to the stego image file (expected 32 bytes).\n");
@@ -334,16 +811,49 @@ Status encode_secret_file_size(int file_size, EncodeInfo *encInfo)
 // Encode the content of the secret file
 Status encode_secret_file_data(EncodeInfo *encInfo)
 {
+    Status status = e_failure;
+    char *buffer = arena_alloc(encInfo->size_secret_file + 1);
     rewind(encInfo->fptr_secret);
-    char buffer[encInfo->size_secret_file];
-    if (fread(buffer, encInfo->size_secret_file, 1, encInfo->fptr_secret) != 1)
+    if (buffer == NULL || (encInfo->size_secret_file > 0 && fread(buffer, encInfo->size_secret_file, 1, encInfo->fptr_secret) != 1))
     {
         fprintf(stderr, "ERROR: ❌ Failed to read %d bytes from secret file.\n", encInfo->size_secret_file);
-        return e_failure;
+        goto out;
+    }
+    encInfo->secret_crc = crc32_update(0, buffer, encInfo->size_secret_file);
+    if (encInfo->matrix_k > 0)
+    {
+        if (encode_matrix_data_to_image(buffer, encInfo->size_secret_file, encInfo->matrix_k, encInfo->fptr_src_image, encInfo->fptr_stego_image, get_verify_info(encInfo)) == e_failure)
+        {
+            fprintf(stderr, "ERROR: ❌ Failed to matrix encode secret file data into the stego image.\n");
+            goto out;
+        }
     }
-    if (encode_data_to_image(buffer, encInfo->size_secret_file, encInfo->fptr_src_image, encInfo->fptr_stego_image) == e_failure)
+    else if (encode_data_to_image(buffer, encInfo->size_secret_file, encInfo->fptr_src_image, encInfo->fptr_stego_image, get_verify_info(encInfo)) == e_failure)
     {
         fprintf(stderr, "ERROR: ❌ Failed to encode secret file data into the stego image.\n");
+        goto out;
+    }
+    status = e_success;
+
+out:
+    arena_free(buffer);
+    return status;
+}
+
+// Encode the CRC-32 of the secret file after its data
+Status encode_secret_file_crc(EncodeInfo *encInfo)
+{
+    char buffer[32];
+    if (fread(buffer, 32, 1, encInfo->fptr_src_image) != 1)
+    {
+        fprintf(stderr, "ERROR: ❌ Unable to read 32 bytes from the source image for encoding the checksum.\n");
+        return e_failure;
+    }
+    encode_int_to_lsb(encInfo->secret_crc, buffer);
+    verify_int_window(encInfo, encInfo->secret_crc, buffer);
+    if (fwrite(buffer, 32, 1, encInfo->fptr_stego_image) != 1)
+    {
+        fprintf(stderr, "ERROR: ❌ Failed to write the encoded checksum to the stego image file.\n");
         return e_failure;
     }
     return e_success;
@@ -1,7 +1,10 @@
 #ifndef ENCODE_H
 #define ENCODE_H
 
+#include <limits.h>
+#include "adapter.h" // ImageFormat
 #include "types.h" // Contains user defined types
+#include "checksum.h"
 
 /*
  * Structure to store information required for
@@ -13,26 +16,51 @@
 #define MAX_SECRET_BUF_SIZE 1
 #define MAX_IMAGE_BUF_SIZE (MAX_SECRET_BUF_SIZE * 8)
 #define MAX_FILE_SUFFIX 4
+#define CACHE_KEY_SIZE 49 // Three 64-bit hashes in hex plus NUL
 
 typedef struct _EncodeInfo
 {
     /* Source Image info */
     char *src_image_fname;
     FILE *fptr_src_image;
-    uint image_capacity;
+    ImageFormat src_format;   // BMP, or a format read through an adapter
+    uint raw_width, raw_height; // Frame size of a raw RGB cover
+    unsigned long long image_capacity;
     // uint bits_per_pixel;
     // char image_data[MAX_IMAGE_BUF_SIZE];
 
     /* Secret File Info */
     char *secret_fname;
     FILE *fptr_secret;
-    char extn_secret_file[MAX_FILE_SUFFIX];
+    char extn_secret_file[MAX_FILE_SUFFIX + 1]; // Room for the terminator after ".txt"
     // char secret_data[MAX_SECRET_BUF_SIZE];
     int size_secret_file;
 
     /* Stego Image Info */
     char *stego_image_fname;
     FILE *fptr_stego_image;
+    ImageFormat stego_format; // BMP, or the cover's own format
+
+    /* Encode options */
+    int matrix_k; // 0 = plain LSB, MATRIX_AUTO or k for matrix embedding
+    char *auto_cover_dir;           // Pick the cover from this directory's index
+    char auto_cover_fname[PATH_MAX]; // Path of the picked cover
+    int verify;                      // Re-extract every window before it is written
+    VerifyInfo verify_info;          // Running verify state
+    uint secret_crc;                 // CRC-32 of the secret file data
+    int update_mode;                 // UPDATE_APPEND/UPDATE_REPLACE patch an existing stego image
+    char *cache_dir;                 // Result cache directory, NULL when caching is off
+    uint cache_max_mb;               // Cache size bound
+    char cache_key[CACHE_KEY_SIZE];  // Content address of this job
+    int pipeline;                    // Read, embed and write on separate threads
+    int adaptive;                    // Embed into the most textured bytes only
+    int channels;                    // CHANNEL_* mask to embed into, 0 for every byte
+    int resume;                      // Continue from the output's checkpoint journal
+    uint checkpoint_mb;              // Output MB between pipeline checkpoints
+    uint block_kb;                   // Pipeline block size
+    uint mem_mb;                     // Memory budget for streaming the cover, 0 for none
+    struct _JobControl *control;     // Cancel, deadline and progress of an async job, else NULL
+    char *io_buf[2];                 // Arena stdio buffers of the source and stego images
 
 } EncodeInfo;
 
@@ -41,6 +69,21 @@ typedef struct _EncodeInfo
 /* Check operation type */
 OperationType check_operation_type(char *argv[]);
 
+/* Strip --options from argv and store them in encInfo */
+Status read_encode_options(int *argc, char *argv[], EncodeInfo *encInfo);
+
+/* Pick the smallest indexed cover that fits the secret and put it in argv */
+Status select_auto_cover(int *argc, char *argv[], EncodeInfo *encInfo);
+
+/* Cover bytes left for the extension and data once the fixed header is taken */
+unsigned long long cover_payload_capacity(unsigned long long image_capacity);
+
+/* Cover bytes past the fixed header a payload needs, with matrix k (0 for plain LSB) */
+unsigned long long payload_cover_need(EncodeInfo *encInfo, uint extn_size, uint file_size, int k);
+
+/* Check the secret file extension and store it */
+Status validate_secret_fname(char *fname, EncodeInfo *encInfo);
+
 /* Read and validate Encode args from argv */
 Status read_and_validate_encode_args(char *argv[], EncodeInfo *encInfo);
 
@@ -54,10 +97,10 @@ Status open_files(EncodeInfo *encInfo);
 Status check_capacity(EncodeInfo *encInfo);
 
 /* Get image size */
-uint get_image_size_for_bmp(FILE *fptr_image);
+unsigned long long get_image_size_for_bmp(FILE *fptr_image);
 
 /* Get file size */
-uint get_file_size(FILE *fptr);
+long long get_file_size(FILE *fptr);
 
 /* Copy bmp image header */
 Status copy_bmp_header(FILE *fptr_src_image, FILE *fptr_dest_image);
@@ -80,8 +123,17 @@ Status encode_secret_file_size(int file_size, EncodeInfo *encInfo);
 /* Encode secret file data*/
 Status encode_secret_file_data(EncodeInfo *encInfo);
 
+/* Encode secret file checksum trailer */
+Status encode_secret_file_crc(EncodeInfo *encInfo);
+
+/* Verify state for the encode helpers, NULL when not verifying */
+VerifyInfo *get_verify_info(EncodeInfo *encInfo);
+
 /* Encode function, which does the real encoding */
-Status encode_data_to_image(const char *data, int size, FILE *fptr_src_image, FILE *fptr_stego_image);
+Status encode_data_to_image(const char *data, int size, FILE *fptr_src_image, FILE *fptr_stego_image, VerifyInfo *verify);
+
+/* Format flags stored with the extension size */
+int get_encode_flags(EncodeInfo *encInfo);
 
 /* Encode a byte into LSB of image data array */
 Status encode_byte_to_lsb(char data, char *image_buffer);
@@ -0,0 +1,264 @@
+/*
+Documentation
+Name       :G Gangadhar
+Date       :30/07/2025
+Description:Steganography project
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <limits.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "arena.h"
+#include "checksum.h"
+#include "common.h"
+#include "encode.h"
+#include "fanout.h"
+#include "plan.h"
+#include "profile.h"
+#include "update.h"
+#include "types.h"
+
+// Validate the secret, the output directory and every cover name
+Status read_and_validate_fanout_args(int argc, char *argv[], FanoutInfo *fanInfo)
+{
+    struct stat st;
+    int i;
+
+    if (fanInfo->enc.matrix_k != 0 || fanInfo->enc.update_mode != UPDATE_NONE || fanInfo->enc.auto_cover_dir != NULL ||
+        fanInfo->enc.adaptive || fanInfo->enc.channels || fanInfo->enc.pipeline || fanInfo->enc.raw_width != 0)
+    {
+        // --pipeline, --mem-mb and --resume all set pipeline; fan-out runs its own spread and writers, on BMP covers only
+        printf("ERROR: ❌ Fan-out only supports plain LSB embedding (--verify and --block-kb are allowed)\n");
+        return e_failure;
+    }
+    fanInfo->enc.cache_dir = NULL;
+    if (validate_secret_fname(argv[2], &fanInfo->enc) == e_failure)
+    {
+        return e_failure;
+    }
+
+    fanInfo->out_dir = argv[3];
+    if (mkdir(fanInfo->out_dir, 0755) != 0 && errno != EEXIST)
+    {
+        perror("mkdir");
+        return e_failure;
+    }
+    if (stat(fanInfo->out_dir, &st) != 0 || !S_ISDIR(st.st_mode))
+    {
+        printf("ERROR: ❌ %s is not a directory\n", fanInfo->out_dir);
+        return e_failure;
+    }
+
+    fanInfo->covers = argv + 4;
+    fanInfo->count = argc - 4;
+    for (i = 0; i < fanInfo->count; i++)
+    {
+        char *bmp = strstr(fanInfo->covers[i], ".bmp");
+        if (bmp == NULL || strcmp(bmp, ".bmp") != 0)
+        {
+            printf("ERROR: ❌ Invalid cover image name %s\n", fanInfo->covers[i]);
+            printf("[INFO] Cover images must have a .bmp extension\n");
+            return e_failure;
+        }
+    }
+    return e_success;
+}
+
+// Expand the whole payload by embedding it into a zeroed cover
+Status fanout_build_spread(FanoutInfo *fanInfo)
+{
+    EncodeInfo *encInfo = &fanInfo->enc;
+    EmbedPlan plan;
+    FILE *fptr = fopen(encInfo->secret_fname, "r");
+    char *secret;
+
+    if (fptr == NULL)
+    {
+        perror("fopen");
+        fprintf(stderr, "ERROR: ❌Unable to open file %s\n", encInfo->secret_fname);
+        return e_failure;
+    }
+    long long file_size = get_file_size(fptr);
+    if (file_size > MAX_SECRET_SIZE)
+    {
+        printf("ERROR: ❌ Secret file is larger than the %d bytes the size field can describe\n", MAX_SECRET_SIZE);
+        fclose(fptr);
+        return e_failure;
+    }
+    encInfo->size_secret_file = file_size;
+    rewind(fptr);
+    secret = malloc(encInfo->size_secret_file + 1);
+    if (secret == NULL ||
+        (encInfo->size_secret_file > 0 && fread(secret, encInfo->size_secret_file, 1, fptr) != 1))
+    {
+        fprintf(stderr, "ERROR: ❌ Failed to read %d bytes from secret file.\n", encInfo->size_secret_file);
+        free(secret);
+        fclose(fptr);
+        return e_failure;
+    }
+    fclose(fptr);
+
+    encInfo->secret_crc = crc32_update(0, secret, encInfo->size_secret_file);
+    plan_build(encInfo, secret, &plan);
+    fanInfo->spread_len = plan.end - 54;
+    fanInfo->spread = calloc(fanInfo->spread_len, 1);
+    if (fanInfo->spread == NULL)
+    {
+        fprintf(stderr, "ERROR: ❌ Out of memory for %zu spread bytes\n", fanInfo->spread_len);
+        free(secret);
+        return e_failure;
+    }
+    plan_embed_block(&plan, 54, (char *)fanInfo->spread, fanInfo->spread_len, NULL);
+    free(secret);
+    printf("[INFO] Expanded %s into %zu cover bytes\n", encInfo->secret_fname, fanInfo->spread_len);
+    return e_success;
+}
+
+// Replace the LSBs of len cover bytes; returns how many do not read back as the spread
+static uint merge_spread(unsigned char *cover, const unsigned char *spread, size_t len, int verify)
+{
+    uint mismatches = 0;
+    size_t i;
+    for (i = 0; i < len; i++)
+    {
+        cover[i] = (cover[i] & 0xFE) | spread[i];
+    }
+    if (verify)
+    {
+        for (i = 0; i < len; i++)
+        {
+            mismatches += (cover[i] ^ spread[i]) & 1;
+        }
+    }
+    return mismatches;
+}
+
+// Stream one cover through the merge into out_dir, publishing it with a rename
+static Status fanout_one(FanoutInfo *fanInfo, const char *cover, unsigned char *buffer, size_t block_size)
+{
+    char out_path[PATH_MAX], tmp_path[PATH_MAX + 16];
+    const char *base = strrchr(cover, '/');
+    long long payload_end = 54 + (long long)fanInfo->spread_len;
+    long long offset = 0;
+    uint mismatches = 0;
+    struct stat src_st, out_st;
+    FILE *in, *out;
+    size_t n;
+
+    snprintf(out_path, sizeof(out_path), "%s/%s", fanInfo->out_dir, base != NULL ? base + 1 : cover);
+    if (stat(cover, &src_st) == 0 && stat(out_path, &out_st) == 0 &&
+        src_st.st_dev == out_st.st_dev && src_st.st_ino == out_st.st_ino)
+    {
+        printf("ERROR: ❌ %s would overwrite its own cover\n", out_path);
+        return e_failure;
+    }
+
+    in = fopen(cover, "r");
+    if (in == NULL)
+    {
+        perror("fopen");
+        fprintf(stderr, "ERROR: ❌Unable to open file %s\n", cover);
+        return e_failure;
+    }
+    if (get_image_size_for_bmp(in) <= (unsigned long long)payload_end)
+    {
+        printf("ERROR: ❌ Insufficient capacity in %s\n", cover);
+        fclose(in);
+        return e_failure;
+    }
+    rewind(in);
+
+    snprintf(tmp_path, sizeof(tmp_path), "%s.%ld.tmp", out_path, (long)getpid());
+    out = fopen(tmp_path, "w");
+    if (out == NULL)
+    {
+        perror("fopen");
+        fclose(in);
+        return e_failure;
+    }
+    while ((n = fread(buffer, 1, block_size, in)) > 0)
+    {
+        // Only the part of the block inside [54, payload_end) carries payload
+        long long from = offset > 54 ? offset : 54;
+        long long to = offset + (long long)n < payload_end ? offset + (long long)n : payload_end;
+        if (from < to)
+        {
+            mismatches += merge_spread(buffer + (from - offset), fanInfo->spread + (from - 54), to - from, fanInfo->enc.verify);
+        }
+        if (fwrite(buffer, n, 1, out) != 1)
+        {
+            break;
+        }
+        offset += n;
+    }
+    fclose(in);
+    if (fclose(out) != 0 || offset < payload_end || mismatches != 0 || rename(tmp_path, out_path) != 0)
+    {
+        printf("ERROR: ❌ Failed to encode %s (%u mismatched bytes)\n", out_path, mismatches);
+        unlink(tmp_path);
+        return e_failure;
+    }
+    printf("[INFO] ✅ %s -> %s\n", cover, out_path);
+    return e_success;
+}
+
+// Worker: claim covers one at a time until none are left
+static void *fanout_worker(void *arg)
+{
+    FanoutInfo *fanInfo = arg;
+    size_t block_size = (size_t)fanInfo->enc.block_kb << 10;
+    unsigned char *buffer = arena_alloc(block_size);
+    int i;
+
+    if (buffer == NULL)
+    {
+        return NULL;
+    }
+    while ((i = atomic_fetch_add(&fanInfo->next, 1)) < fanInfo->count)
+    {
+        if (fanout_one(fanInfo, fanInfo->covers[i], buffer, block_size) == e_success)
+        {
+            atomic_fetch_add(&fanInfo->done, 1);
+        }
+        arena_job_done();
+    }
+    arena_free(buffer);
+    return NULL;
+}
+
+// Run the covers on a thread pool sized by the host profile
+Status do_fanout(FanoutInfo *fanInfo)
+{
+    pthread_t threads[FANOUT_MAX_THREADS];
+    int i, nthreads = profile_threads(FANOUT_MAX_THREADS);
+
+    atomic_init(&fanInfo->next, 0);
+    atomic_init(&fanInfo->done, 0);
+    if (nthreads > fanInfo->count)
+    {
+        nthreads = fanInfo->count;
+    }
+    for (i = 0; i < nthreads - 1; i++)
+    {
+        if (pthread_create(&threads[i], NULL, fanout_worker, fanInfo) != 0)
+        {
+            break;
+        }
+    }
+    // The calling thread takes its share too
+    fanout_worker(fanInfo);
+    while (i-- > 0)
+    {
+        pthread_join(threads[i], NULL);
+    }
+    free(fanInfo->spread);
+    fanInfo->spread = NULL;
+
+    printf("[INFO] Fan-out encoded %d of %d covers into %s\n", atomic_load(&fanInfo->done), fanInfo->count, fanInfo->out_dir);
+    arena_report();
+    return atomic_load(&fanInfo->done) == fanInfo->count ? e_success : e_failure;
+}
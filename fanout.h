@@ -0,0 +1,39 @@
+#ifndef FANOUT_H
+#define FANOUT_H
+
+#include <stdatomic.h>
+#include "encode.h" // EncodeInfo
+#include "types.h"  // User-defined data types
+
+/*
+ * Fan-out: one secret into many covers in one run.
+ * The header, data and checksum are expanded once into their bit-spread
+ * form, one byte per cover byte holding the bit its LSB must take. The
+ * spread is shared read-only by the workers, so each cover is a plain
+ * streaming merge: out = (cover & 0xFE) | spread.
+ */
+
+#define FANOUT_MAX_THREADS 16
+
+typedef struct _FanoutInfo
+{
+    EncodeInfo enc;              // Secret file and encode options
+    unsigned char *spread;       // LSB of every cover byte from offset 54 on
+    size_t spread_len;
+    char *out_dir;               // Stego images are written here under the cover's name
+    char **covers;               // Cover image names
+    int count;
+    _Atomic int next;            // Next cover to claim
+    _Atomic int done;            // Covers encoded successfully
+} FanoutInfo;
+
+/* Validate "<secret_file> <out_dir> <cover.bmp>..." from argv */
+Status read_and_validate_fanout_args(int argc, char *argv[], FanoutInfo *fanInfo);
+
+/* Read the secret once and expand header, data and checksum into the spread */
+Status fanout_build_spread(FanoutInfo *fanInfo);
+
+/* Merge the spread into every cover on a thread pool */
+Status do_fanout(FanoutInfo *fanInfo);
+
+#endif
@@ -0,0 +1,166 @@
+/*
+Documentation
+Name       :G Gangadhar
+Date       :30/07/2025
+Description:Steganography project
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "checksum.h"
+#include "journal.h"
+#include "types.h"
+
+// Mix a file's name, size and mtime into the key; a missing file mixes in only its name
+static unsigned long long key_file(unsigned long long seed, const char *fname)
+{
+    struct stat st;
+    long long meta[3] = {0, 0, 0};
+
+    seed = xxh64(fname, strlen(fname), seed);
+    if (stat(fname, &st) == 0)
+    {
+        meta[0] = st.st_size;
+        meta[1] = st.st_mtim.tv_sec;
+        meta[2] = st.st_mtim.tv_nsec;
+    }
+    return xxh64(meta, sizeof(meta), seed);
+}
+
+unsigned long long journal_key(const char *fname1, const char *fname2, const char *params)
+{
+    unsigned long long key = key_file(0, fname1);
+    if (fname2 != NULL)
+    {
+        key = key_file(key, fname2);
+    }
+    return xxh64(params, strlen(params), key);
+}
+
+void journal_init(Journal *journal, const char *output, unsigned long long key, uint interval_mb)
+{
+    memset(journal, 0, sizeof(*journal));
+    snprintf(journal->path, sizeof(journal->path), "%s%s", output, JOURNAL_SUFFIX);
+    journal->key = key;
+    journal->interval = (unsigned long long)(interval_mb ? interval_mb : JOURNAL_DEFAULT_INTERVAL_MB) << 20;
+}
+
+// Read back the committed region of the output and compare its CRC
+static Status verify_output(const Journal *journal, FILE *fptr_output)
+{
+    char *buffer = malloc(1 << 20);
+    long long left = journal->out_offset - journal->out_start;
+    uint crc = 0;
+    struct stat st;
+
+    fflush(fptr_output);
+    if (buffer == NULL || fstat(fileno(fptr_output), &st) != 0 || st.st_size < journal->out_offset ||
+        fseek(fptr_output, journal->out_start, SEEK_SET) != 0)
+    {
+        free(buffer);
+        return e_failure;
+    }
+    while (left > 0)
+    {
+        size_t n = left < (1 << 20) ? left : (1 << 20);
+        if (fread(buffer, n, 1, fptr_output) != 1)
+        {
+            free(buffer);
+            return e_failure;
+        }
+        crc = crc32_update(crc, buffer, n);
+        left -= n;
+    }
+    free(buffer);
+    return crc == journal->out_crc ? e_success : e_failure;
+}
+
+Status journal_resume(Journal *journal, FILE *fptr_output)
+{
+    char line[128];
+    unsigned long long key;
+    int i;
+    FILE *fptr = fopen(journal->path, "r");
+
+    if (fptr == NULL)
+    {
+        printf("[INFO] No journal %s; starting from the beginning\n", journal->path);
+        return e_failure;
+    }
+    if (fgets(line, sizeof(line), fptr) == NULL || strncmp(line, JOURNAL_VERSION, strlen(JOURNAL_VERSION)) != 0 ||
+        fscanf(fptr, "key %llx in %lld out_start %lld out %lld crc %x state", &key, &journal->in_offset,
+               &journal->out_start, &journal->out_offset, &journal->out_crc) != 5)
+    {
+        printf("[INFO] Unreadable journal %s; starting from the beginning\n", journal->path);
+        fclose(fptr);
+        return e_failure;
+    }
+    for (i = 0; i < JOURNAL_STATE_WORDS; i++)
+    {
+        if (fscanf(fptr, " %llu", &journal->state[i]) != 1)
+        {
+            fclose(fptr);
+            return e_failure;
+        }
+    }
+    fclose(fptr);
+
+    if (key != journal->key)
+    {
+        printf("[INFO] Journal %s belongs to another job; starting from the beginning\n", journal->path);
+        return e_failure;
+    }
+    if (verify_output(journal, fptr_output) == e_failure)
+    {
+        printf("[INFO] Partial output does not match journal %s; starting from the beginning\n", journal->path);
+        return e_failure;
+    }
+    journal->last = journal->out_offset;
+    printf("[INFO] Resuming at input offset %lld, output offset %lld\n", journal->in_offset, journal->out_offset);
+    return e_success;
+}
+
+Status journal_commit(Journal *journal, FILE *fptr_output)
+{
+    char tmp_path[sizeof(journal->path) + 8];
+    FILE *fptr;
+    int i;
+
+    // The checkpoint must never get ahead of the data on disk
+    if (fflush(fptr_output) != 0 || fdatasync(fileno(fptr_output)) != 0)
+    {
+        perror("fdatasync");
+        return e_failure;
+    }
+    snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", journal->path);
+    fptr = fopen(tmp_path, "w");
+    if (fptr == NULL)
+    {
+        perror("fopen");
+        return e_failure;
+    }
+    fprintf(fptr, "%s\nkey %016llx in %lld out_start %lld out %lld crc %08x state", JOURNAL_VERSION, journal->key,
+            journal->in_offset, journal->out_start, journal->out_offset, journal->out_crc);
+    for (i = 0; i < JOURNAL_STATE_WORDS; i++)
+    {
+        fprintf(fptr, " %llu", journal->state[i]);
+    }
+    fprintf(fptr, "\n");
+    int failed = fflush(fptr) != 0 || fsync(fileno(fptr)) != 0;
+    if (fclose(fptr) != 0 || failed || rename(tmp_path, journal->path) != 0)
+    {
+        unlink(tmp_path);
+        return e_failure;
+    }
+    journal->last = journal->out_offset;
+    return e_success;
+}
+
+void journal_remove(const char *output)
+{
+    char path[PATH_MAX + 16];
+    snprintf(path, sizeof(path), "%s%s", output, JOURNAL_SUFFIX);
+    unlink(path);
+}
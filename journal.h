@@ -0,0 +1,50 @@
+#ifndef JOURNAL_H
+#define JOURNAL_H
+
+#include <limits.h>
+#include <stdio.h>
+#include "types.h" // User-defined data types
+
+/*
+ * Checkpoint journal for --resume pipelined jobs, kept next to the output
+ * as "<output>.journal". Every few MB the writer stage syncs the output
+ * and records how far input and output are committed, a CRC-32 of the
+ * output written by the pipeline and the stage state at that point.
+ * --resume checks the partial output against the CRC and carries on from
+ * there. The journal is removed once the job completes.
+ */
+
+#define JOURNAL_SUFFIX ".journal"
+#define JOURNAL_VERSION "# stego journal v1"
+#define JOURNAL_DEFAULT_INTERVAL_MB 64
+#define JOURNAL_STATE_WORDS 4
+
+typedef struct _Journal
+{
+    char path[PATH_MAX + 16];
+    unsigned long long key;       // Identifies the job: inputs, their size and mtime, options
+    long long in_offset;          // Input bytes committed
+    long long out_start;          // Output offset where the pipeline began writing
+    long long out_offset;         // Output bytes committed
+    uint out_crc;                 // CRC-32 of output[out_start, out_offset)
+    unsigned long long state[JOURNAL_STATE_WORDS]; // Stage state at the checkpoint
+    unsigned long long interval;  // Output bytes between checkpoints
+    long long last;               // out_offset of the previous checkpoint
+} Journal;
+
+/* Key a job from its input files (fname2 may be NULL) and an option string */
+unsigned long long journal_key(const char *fname1, const char *fname2, const char *params);
+
+/* Set up the journal of an output file; nothing is written yet */
+void journal_init(Journal *journal, const char *output, unsigned long long key, uint interval_mb);
+
+/* Load a previous checkpoint for the same job and check the output against it */
+Status journal_resume(Journal *journal, FILE *fptr_output);
+
+/* Sync the output, then atomically record the checkpoint */
+Status journal_commit(Journal *journal, FILE *fptr_output);
+
+/* Delete the journal of an output file */
+void journal_remove(const char *output);
+
+#endif
@@ -0,0 +1,190 @@
+/*
+Documentation
+Name       :G Gangadhar
+Date       :30/07/2025
+Description:Steganography project
+*/
+#include <stdio.h>
+#include <string.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+#include "decode.h"
+#include "encode.h"
+#include "lsb.h"
+#include "types.h"
+
+#define LSB_ONES 0x0101010101010101ULL   // The LSB of every byte of a word
+#define LSB_SELECT 0x0102040810204080ULL // Byte i keeps bit 7 - i of a repeated byte
+#define LSB_GATHER 0x8040201008040201ULL // Moves the LSB of byte i to bit 63 - i
+
+// Reference kernel: the byte-at-a-time functions the stepwise encoder uses
+static void embed_scalar(const char *data, size_t n, char *cover)
+{
+    size_t i;
+    for (i = 0; i < n; i++)
+    {
+        encode_byte_to_lsb(data[i], cover + i * 8);
+    }
+}
+
+static void extract_scalar(const char *cover, size_t n, char *data)
+{
+    size_t i;
+    for (i = 0; i < n; i++)
+    {
+        decode_byte_from_lsb(&data[i], (char *)cover + i * 8);
+    }
+}
+
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+// One payload byte per 64-bit word: spread its bits over the 8 LSBs without a loop
+static void embed_swar(const char *data, size_t n, char *cover)
+{
+    size_t i;
+    for (i = 0; i < n; i++)
+    {
+        unsigned long long word, bits = ((unsigned char)data[i] * LSB_ONES) & LSB_SELECT;
+        // A byte holding one set bit becomes 1, an empty byte stays 0
+        bits = ((bits + 0x7F7F7F7F7F7F7F7FULL) >> 7) & LSB_ONES;
+        memcpy(&word, cover + i * 8, 8);
+        word = (word & ~LSB_ONES) | bits;
+        memcpy(cover + i * 8, &word, 8);
+    }
+}
+
+static void extract_swar(const char *cover, size_t n, char *data)
+{
+    size_t i;
+    for (i = 0; i < n; i++)
+    {
+        unsigned long long word;
+        memcpy(&word, cover + i * 8, 8);
+        data[i] = ((word & LSB_ONES) * LSB_GATHER) >> 56;
+    }
+}
+#endif
+
+#ifdef __SSE2__
+// 16 payload bytes per step: each is repeated over 8 lanes and tested against its bit
+static void embed_sse2(const char *data, size_t n, char *cover)
+{
+    const __m128i sel = _mm_set_epi8(1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128);
+    const __m128i one = _mm_set1_epi8(1);
+    const __m128i keep = _mm_set1_epi8((char)0xFE);
+    size_t i = 0;
+    int j, h;
+
+    for (; i + 16 <= n; i += 16)
+    {
+        __m128i p = _mm_loadu_si128((const __m128i *)(data + i));
+        __m128i lo = _mm_unpacklo_epi8(p, p), hi = _mm_unpackhi_epi8(p, p);
+        __m128i quad[4] = {_mm_unpacklo_epi16(lo, lo), _mm_unpackhi_epi16(lo, lo),
+                           _mm_unpacklo_epi16(hi, hi), _mm_unpackhi_epi16(hi, hi)};
+        for (j = 0; j < 4; j++)
+        {
+            // Payload bytes 4j .. 4j + 3, two per vector of 16 cover bytes
+            __m128i pair[2] = {_mm_unpacklo_epi32(quad[j], quad[j]), _mm_unpackhi_epi32(quad[j], quad[j])};
+            for (h = 0; h < 2; h++)
+            {
+                __m128i *out = (__m128i *)(cover + (i + j * 4 + h * 2) * 8);
+                __m128i bits = _mm_and_si128(_mm_cmpeq_epi8(_mm_and_si128(pair[h], sel), sel), one);
+                _mm_storeu_si128(out, _mm_or_si128(_mm_and_si128(_mm_loadu_si128(out), keep), bits));
+            }
+        }
+    }
+    embed_swar(data + i, n - i, cover + i * 8);
+}
+
+// 64 cover bytes per step through movemask, then every byte of the mask bit-reversed
+static void extract_sse2(const char *cover, size_t n, char *data)
+{
+    size_t i = 0;
+    int j;
+
+    for (; i + 8 <= n; i += 8)
+    {
+        const __m128i *src = (const __m128i *)(cover + i * 8);
+        unsigned long long mask = 0;
+        for (j = 0; j < 4; j++)
+        {
+            unsigned short m = _mm_movemask_epi8(_mm_slli_epi16(_mm_loadu_si128(src + j), 7));
+            mask |= (unsigned long long)m << (16 * j);
+        }
+        mask = ((mask & 0xF0F0F0F0F0F0F0F0ULL) >> 4) | ((mask & 0x0F0F0F0F0F0F0F0FULL) << 4);
+        mask = ((mask & 0xCCCCCCCCCCCCCCCCULL) >> 2) | ((mask & 0x3333333333333333ULL) << 2);
+        mask = ((mask & 0xAAAAAAAAAAAAAAAAULL) >> 1) | ((mask & 0x5555555555555555ULL) << 1);
+        memcpy(data + i, &mask, 8);
+    }
+    extract_swar(cover + i * 8, n - i, data + i);
+}
+#endif
+
+static const LsbKernel kernels[] = {
+    {"scalar", embed_scalar, extract_scalar},
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    {"swar", embed_swar, extract_swar},
+#ifdef __SSE2__
+    {"sse2", embed_sse2, extract_sse2},
+#endif
+#endif
+};
+
+#define KERNEL_COUNT ((int)(sizeof(kernels) / sizeof(kernels[0])))
+
+// The widest kernel built is the default until a profile says otherwise
+static const LsbKernel *active_embed = &kernels[KERNEL_COUNT - 1];
+static const LsbKernel *active_extract = &kernels[KERNEL_COUNT - 1];
+
+const LsbKernel *lsb_kernels(int *count)
+{
+    *count = KERNEL_COUNT;
+    return kernels;
+}
+
+// Look a kernel up by name
+static const LsbKernel *find_kernel(const char *name)
+{
+    int i;
+    for (i = 0; i < KERNEL_COUNT; i++)
+    {
+        if (strcmp(kernels[i].name, name) == 0)
+        {
+            return &kernels[i];
+        }
+    }
+    return NULL;
+}
+
+Status lsb_select(const char *embed_name, const char *extract_name)
+{
+    const LsbKernel *embed = find_kernel(embed_name);
+    const LsbKernel *extract = find_kernel(extract_name);
+    if (embed == NULL || extract == NULL)
+    {
+        return e_failure;
+    }
+    active_embed = embed;
+    active_extract = extract;
+    return e_success;
+}
+
+const char *lsb_embed_name(void)
+{
+    return active_embed->name;
+}
+
+const char *lsb_extract_name(void)
+{
+    return active_extract->name;
+}
+
+void lsb_embed(const char *data, size_t n, char *cover)
+{
+    active_embed->embed(data, n, cover);
+}
+
+void lsb_extract(const char *cover, size_t n, char *data)
+{
+    active_extract->extract(cover, n, data);
+}
@@ -0,0 +1,40 @@
+#ifndef LSB_H
+#define LSB_H
+
+#include <stddef.h>
+#include "types.h" // User-defined data types
+
+/*
+ * Bulk LSB kernels: n payload bytes go into (or come out of) the LSBs of
+ * n * 8 cover bytes, MSB first, exactly like encode_byte_to_lsb and
+ * decode_byte_from_lsb one byte at a time. Which kernel is fastest
+ * depends on the machine, so the active pair is chosen at startup from
+ * the host profile (see profile.h); the default is the widest one built.
+ */
+
+#define LSB_KERNEL_NAME_SIZE 16
+
+typedef struct _LsbKernel
+{
+    const char *name;
+    void (*embed)(const char *data, size_t n, char *cover);
+    void (*extract)(const char *cover, size_t n, char *data);
+} LsbKernel;
+
+/* Kernels built into this binary, the reference one first */
+const LsbKernel *lsb_kernels(int *count);
+
+/* Use the named kernels from now on; call before starting any threads */
+Status lsb_select(const char *embed_name, const char *extract_name);
+
+/* Names of the active kernels */
+const char *lsb_embed_name(void);
+const char *lsb_extract_name(void);
+
+/* Embed n payload bytes into n * 8 cover bytes with the active kernel */
+void lsb_embed(const char *data, size_t n, char *cover);
+
+/* Extract n payload bytes from n * 8 cover bytes with the active kernel */
+void lsb_extract(const char *cover, size_t n, char *data);
+
+#endif
@@ -5,8 +5,15 @@ Date       :30/07/2025
 Description:Steganography project
 */
 #include <stdio.h>
+#include <limits.h>
 #include "encode.h"
 #include "decode.h"
+#include "cover_index.h"
+#include "cache.h"
+#include "fanout.h"
+#include "profile.h"
+#include "tune.h"
+#include "watch.h"
 #include "types.h"
 #include "common.h"
 
@@ -21,17 +28,44 @@ int main(int argc, char *argv[])
     {
         // Print usage info for both encoding and decoding
         printf("Usage:\n");
-        printf("Encoding: ./a.out -e <image_file.bmp> <secret_file.txt|.c|.sh> [optional_image.bmp]\n");
-        printf("Decoding: ./a.out -d <image_file.bmp> [optional_secret_file]\n");
+        printf("Encoding: ./a.out -e <image_file.bmp|.ppm|.tga|.rgb> <secret_file.txt|.c|.sh> [optional_image.bmp|same format] [--matrix[=k]] [--verify] [--auto-cover=<dir>] [--cache=<dir>] [--pipeline [--block-kb=N]] [--mem-mb=N] [--resume] [--adaptive] [--channels=<letters of BGRA>] [--raw-size=WxH]\n");
+        printf("Updating: ./a.out -e <stego_image.bmp> <secret_file> --append|--update [--verify]\n");
+        printf("Decoding: ./a.out -d <image_file.bmp|.ppm|.tga|.rgb> [optional_secret_file] [--pipeline [--block-kb=N]] [--mem-mb=N] [--resume] [--raw-size=WxH]\n");
+        printf("Indexing: ./a.out -i <cover_directory>\n");
+        printf("Fan-out:  ./a.out -f <secret_file> <output_directory> <cover.bmp>... [--verify] [--block-kb=N]\n");
+        printf("Tuning:   ./a.out tune [scratch_directory] [--size-mb=N]\n");
+        printf("Watching: ./a.out watch <spool_directory> <output_directory> [encode options] [--batch-ms=N] [--max-batch=N] [--metrics=<file>]\n");
         return 1;
     }
 
     // Get the type of operation (encode or decode)
     OperationType op_type = check_operation_type(argv);
 
+    // Kernels, block size and thread count measured for this host by tune; only reported where they drive the run
+    const Profile *profile = profile_load();
+    if (profile->loaded && (op_type == e_encode || op_type == e_decode))
+    {
+        printf("[INFO] Host profile: %s/%s kernels, %u KB blocks, %d thread(s)\n", profile->embed, profile->extract,
+               profile->block_kb, profile_threads(INT_MAX));
+    }
+
     // If encoding operation
     if (op_type == e_encode)
     {
+        // Pull out --options before counting positional arguments
+        if (read_encode_options(&argc, argv, &encodeInfo) == e_failure)
+        {
+            fprintf(stderr, "Error: ❌ Invalid encoding options.\n");
+            return e_failure;
+        }
+
+        // Let the cover index choose the source image
+        if (encodeInfo.auto_cover_dir != NULL && select_auto_cover(&argc, argv, &encodeInfo) == e_failure)
+        {
+            fprintf(stderr, "Error: ❌ Unable to select a cover image.\n");
+            return e_failure;
+        }
+
         // Check if correct number of arguments for encoding
         if (argc >= 4 && argc <= 5)
         {
@@ -43,6 +77,16 @@ int main(int argc, char *argv[])
                 return e_failure;
             }
             printf("[INFO] ✅ Done\n\n");
+
+            // Reuse an earlier result for the same cover, secret and options
+            if (encodeInfo.cache_dir != NULL && cache_lookup(&encodeInfo) == e_success)
+            {
+                printf("──────────────────────────────────────────────\n");
+                printf("[INFO]  ✅ Encoding Completed Successfully! (cached)\n");
+                printf("──────────────────────────────────────────────\n");
+                return 0;
+            }
+
             // Start encoding process
             if (do_encoding(&encodeInfo) == e_failure)
             {
@@ -54,6 +98,10 @@ int main(int argc, char *argv[])
 
             // Close files and confirm success
             close_encode_files(&encodeInfo);
+            if (encodeInfo.cache_dir != NULL)
+            {
+                cache_store(&encodeInfo);
+            }
             printf("──────────────────────────────────────────────\n");
             printf("[INFO]  ✅ Encoding Completed Successfully!\n");
             printf("──────────────────────────────────────────────\n");
@@ -64,7 +112,7 @@ int main(int argc, char *argv[])
             // Handle incorrect argument count for encoding
             fprintf(stderr, "Error: ❌ Invalid number of arguments for encoding.\n");
             printf("Usage:\n");
-            printf("Encoding: ./a.out -e <image_file.bmp> <secret_file.txt|.c|.sh> [optional_image.bmp]\n");
+            printf("Encoding: ./a.out -e <image_file.bmp|.ppm|.tga|.rgb> <secret_file.txt|.c|.sh> [optional_image.bmp|same format] [--matrix[=k]] [--verify] [--auto-cover=<dir>] [--cache=<dir>] [--pipeline [--block-kb=N]] [--mem-mb=N] [--resume] [--adaptive] [--channels=<letters of BGRA>] [--raw-size=WxH]\n");
             return e_failure;
         }
     }
@@ -72,6 +120,13 @@ int main(int argc, char *argv[])
     // If decoding operation
     else if (op_type == e_decode)
     {
+        // Pull out --options before counting positional arguments
+        if (read_decode_options(&argc, argv, &decodeInfo) == e_failure)
+        {
+            fprintf(stderr, "Error: ❌ Invalid decoding options.\n");
+            return e_failure;
+        }
+
         // Check if correct number of arguments for decoding
         if (argc >= 3 && argc <= 4)
         {
@@ -103,18 +158,120 @@ int main(int argc, char *argv[])
             // Handle incorrect argument count for decoding
             fprintf(stderr, "Error:  ❌ Invalid number of arguments for decoding.\n");
             printf("Usage:\n");
-            printf("Decoding: ./a.out -d <image_file.bmp> [optional_secret_file]\n");
+            printf("Decoding: ./a.out -d <image_file.bmp|.ppm|.tga|.rgb> [optional_secret_file] [--pipeline [--block-kb=N]] [--mem-mb=N] [--resume] [--raw-size=WxH]\n");
+            return e_failure;
+        }
+    }
+
+    // If cover index operation
+    else if (op_type == e_index)
+    {
+        if (argc != 3)
+        {
+            fprintf(stderr, "Error: ❌ Invalid number of arguments for indexing.\n");
+            printf("Usage:\n");
+            printf("Indexing: ./a.out -i <cover_directory>\n");
+            return e_failure;
+        }
+        CoverIndex index;
+        if (cover_index_update(argv[2], &index) == e_failure)
+        {
+            fprintf(stderr, "Error: ❌ Indexing failed.\n");
+            return e_failure;
+        }
+        cover_index_free(&index);
+        printf("[INFO] ✅ Cover index is up to date\n");
+        return 0;
+    }
+
+    // If fan-out operation: one secret into many covers
+    else if (op_type == e_fanout)
+    {
+        FanoutInfo fanoutInfo;
+        if (read_encode_options(&argc, argv, &fanoutInfo.enc) == e_failure)
+        {
+            fprintf(stderr, "Error: ❌ Invalid fan-out options.\n");
+            return e_failure;
+        }
+        if (argc < 5)
+        {
+            fprintf(stderr, "Error: ❌ Invalid number of arguments for fan-out.\n");
+            printf("Usage:\n");
+            printf("Fan-out:  ./a.out -f <secret_file> <output_directory> <cover.bmp>... [--verify] [--block-kb=N]\n");
+            return e_failure;
+        }
+        if (read_and_validate_fanout_args(argc, argv, &fanoutInfo) == e_failure)
+        {
+            fprintf(stderr, "Error: ❌ Invalid fan-out arguments.\n");
+            return e_failure;
+        }
+        if (fanout_build_spread(&fanoutInfo) == e_failure || do_fanout(&fanoutInfo) == e_failure)
+        {
+            fprintf(stderr, "Error: ❌ Fan-out failed.\n");
+            return e_failure;
+        }
+        printf("──────────────────────────────────────────────\n");
+        printf("[INFO]  ✅ Fan-out Completed Successfully!\n");
+        printf("──────────────────────────────────────────────\n");
+        return 0;
+    }
+
+    // If tune operation: benchmark this host and write its profile
+    else if (op_type == e_tune)
+    {
+        TuneInfo tuneInfo;
+        if (read_tune_args(argc, argv, &tuneInfo) == e_failure)
+        {
+            fprintf(stderr, "Error: ❌ Invalid tune arguments.\n");
+            printf("Usage:\n");
+            printf("Tuning:   ./a.out tune [scratch_directory] [--size-mb=N]\n");
+            return e_failure;
+        }
+        if (do_tune(&tuneInfo) == e_failure)
+        {
+            fprintf(stderr, "Error: ❌ Tuning failed.\n");
+            return e_failure;
+        }
+        printf("──────────────────────────────────────────────\n");
+        printf("[INFO]  ✅ Tuning Completed Successfully!\n");
+        printf("──────────────────────────────────────────────\n");
+        return 0;
+    }
+
+    // If watch operation: encode pairs as they land in a spool directory
+    else if (op_type == e_watch)
+    {
+        WatchInfo watchInfo;
+        if (read_and_validate_watch_args(argc, argv, &watchInfo) == e_failure)
+        {
+            fprintf(stderr, "Error: ❌ Invalid watch arguments.\n");
+            printf("Usage:\n");
+            printf("Watching: ./a.out watch <spool_directory> <output_directory> [encode options] [--batch-ms=N] [--max-batch=N] [--metrics=<file>]\n");
+            return e_failure;
+        }
+        if (do_watch(&watchInfo) == e_failure)
+        {
+            fprintf(stderr, "Error: ❌ Watching failed.\n");
             return e_failure;
         }
+        printf("──────────────────────────────────────────────\n");
+        printf("[INFO]  ✅ Watch Stopped Cleanly\n");
+        printf("──────────────────────────────────────────────\n");
+        return 0;
     }
 
-    // If invalid operation type (not -e or -d)
+    // If invalid operation type (not -e, -d, -i, -f, tune or watch)
     else
     {
-        fprintf(stderr, "Error: ❌ Invalid operation type. Use -e or -d.\n");
+        fprintf(stderr, "Error: ❌ Invalid operation type. Use -e, -d, -i, -f, tune or watch.\n");
         printf("Usage:\n");
-        printf("Encoding: ./a.out -e <image_file.bmp> <secret_file.txt|.c|.sh> [optional_image.bmp]\n");
-        printf("Decoding: ./a.out -d <image_file.bmp> [optional_secret_file]\n");
+        printf("Encoding: ./a.out -e <image_file.bmp|.ppm|.tga|.rgb> <secret_file.txt|.c|.sh> [optional_image.bmp|same format] [--matrix[=k]] [--verify] [--auto-cover=<dir>] [--cache=<dir>] [--pipeline [--block-kb=N]] [--mem-mb=N] [--resume] [--adaptive] [--channels=<letters of BGRA>] [--raw-size=WxH]\n");
+        printf("Updating: ./a.out -e <stego_image.bmp> <secret_file> --append|--update [--verify]\n");
+        printf("Decoding: ./a.out -d <image_file.bmp|.ppm|.tga|.rgb> [optional_secret_file] [--pipeline [--block-kb=N]] [--mem-mb=N] [--resume] [--raw-size=WxH]\n");
+        printf("Indexing: ./a.out -i <cover_directory>\n");
+        printf("Fan-out:  ./a.out -f <secret_file> <output_directory> <cover.bmp>... [--verify] [--block-kb=N]\n");
+        printf("Tuning:   ./a.out tune [scratch_directory] [--size-mb=N]\n");
+        printf("Watching: ./a.out watch <spool_directory> <output_directory> [encode options] [--batch-ms=N] [--max-batch=N] [--metrics=<file>]\n");
         return e_failure;
     }
 }
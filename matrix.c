@@ -0,0 +1,242 @@
+/*
+Documentation
+Name       :G Gangadhar
+Date       :30/07/2025
+Description:Steganography project
+*/
+#include <stdio.h>
+#include "checksum.h"
+#include "matrix.h"
+#include "types.h"
+
+/* XOR of the set bit positions (0..7) of every byte value */
+static const unsigned char xor_table[256] = {
+    0, 0, 1, 1, 2, 2, 3, 3, 3, 3, 2, 2, 1, 1, 0, 0,
+    4, 4, 5, 5, 6, 6, 7, 7, 7, 7, 6, 6, 5, 5, 4, 4,
+    5, 5, 4, 4, 7, 7, 6, 6, 6, 6, 7, 7, 4, 4, 5, 5,
+    1, 1, 0, 0, 3, 3, 2, 2, 2, 2, 3, 3, 0, 0, 1, 1,
+    6, 6, 7, 7, 4, 4, 5, 5, 5, 5, 4, 4, 7, 7, 6, 6,
+    2, 2, 3, 3, 0, 0, 1, 1, 1, 1, 0, 0, 3, 3, 2, 2,
+    3, 3, 2, 2, 1, 1, 0, 0, 0, 0, 1, 1, 2, 2, 3, 3,
+    7, 7, 6, 6, 5, 5, 4, 4, 4, 4, 5, 5, 6, 6, 7, 7,
+    7, 7, 6, 6, 5, 5, 4, 4, 4, 4, 5, 5, 6, 6, 7, 7,
+    3, 3, 2, 2, 1, 1, 0, 0, 0, 0, 1, 1, 2, 2, 3, 3,
+    2, 2, 3, 3, 0, 0, 1, 1, 1, 1, 0, 0, 3, 3, 2, 2,
+    6, 6, 7, 7, 4, 4, 5, 5, 5, 5, 4, 4, 7, 7, 6, 6,
+    1, 1, 0, 0, 3, 3, 2, 2, 2, 2, 3, 3, 0, 0, 1, 1,
+    5, 5, 4, 4, 7, 7, 6, 6, 6, 6, 7, 7, 4, 4, 5, 5,
+    4, 4, 5, 5, 6, 6, 7, 7, 7, 7, 6, 6, 5, 5, 4, 4,
+    0, 0, 1, 1, 2, 2, 3, 3, 3, 3, 2, 2, 1, 1, 0, 0,
+};
+
+/* Parity of the number of set bits of every byte value */
+static const unsigned char parity_table[256] = {
+    0, 1, 1, 0, 1, 0, 0, 1, 1, 0, 0, 1, 0, 1, 1, 0,
+    1, 0, 0, 1, 0, 1, 1, 0, 0, 1, 1, 0, 1, 0, 0, 1,
+    1, 0, 0, 1, 0, 1, 1, 0, 0, 1, 1, 0, 1, 0, 0, 1,
+    0, 1, 1, 0, 1, 0, 0, 1, 1, 0, 0, 1, 0, 1, 1, 0,
+    1, 0, 0, 1, 0, 1, 1, 0, 0, 1, 1, 0, 1, 0, 0, 1,
+    0, 1, 1, 0, 1, 0, 0, 1, 1, 0, 0, 1, 0, 1, 1, 0,
+    0, 1, 1, 0, 1, 0, 0, 1, 1, 0, 0, 1, 0, 1, 1, 0,
+    1, 0, 0, 1, 0, 1, 1, 0, 0, 1, 1, 0, 1, 0, 0, 1,
+    1, 0, 0, 1, 0, 1, 1, 0, 0, 1, 1, 0, 1, 0, 0, 1,
+    0, 1, 1, 0, 1, 0, 0, 1, 1, 0, 0, 1, 0, 1, 1, 0,
+    0, 1, 1, 0, 1, 0, 0, 1, 1, 0, 0, 1, 0, 1, 1, 0,
+    1, 0, 0, 1, 0, 1, 1, 0, 0, 1, 1, 0, 1, 0, 0, 1,
+    0, 1, 1, 0, 1, 0, 0, 1, 1, 0, 0, 1, 0, 1, 1, 0,
+    1, 0, 0, 1, 0, 1, 1, 0, 0, 1, 1, 0, 1, 0, 0, 1,
+    1, 0, 0, 1, 0, 1, 1, 0, 0, 1, 1, 0, 1, 0, 0, 1,
+    0, 1, 1, 0, 1, 0, 0, 1, 1, 0, 0, 1, 0, 1, 1, 0,
+};
+
+// Number of k-bit groups needed for size bytes
+uint matrix_group_count(int k, uint size)
+{
+    return (uint)(((unsigned long long)size * 8 + k - 1) / k);
+}
+
+// Number of cover bytes needed for size bytes
+unsigned long long matrix_cover_bytes(int k, uint size)
+{
+    return (unsigned long long)matrix_group_count(k, size) * MATRIX_GROUP_SIZE(k);
+}
+
+// Largest k that fits, so the fewest LSBs are flipped per message bit
+int matrix_choose_k(unsigned long long avail, uint size)
+{
+    int k;
+    for (k = MATRIX_MAX_K; k >= MATRIX_MIN_K; k--)
+    {
+        if (matrix_cover_bytes(k, size) <= avail)
+        {
+            return k;
+        }
+    }
+    return 0;
+}
+
+/*
+ * Syndrome of a group
+ * Cover byte i sits at code position i + 1. The LSBs are packed into a bit
+ * vector indexed by position, then folded a byte at a time: for a chunk c
+ * with bits b, XOR of (8c + t) over set bits t is xor_table[b], plus 8c
+ * when an odd number of bits is set.
+ */
+unsigned char matrix_syndrome(const char *buffer, int n)
+{
+    unsigned char bits[(MATRIX_GROUP_SIZE(MATRIX_MAX_K) + 1) / 8] = {0};
+    unsigned char syndrome = 0;
+    int j, c;
+
+    for (j = 1; j <= n; j++)
+    {
+        bits[j >> 3] |= (buffer[j - 1] & 1) << (j & 7);
+    }
+    for (c = 0; c <= (n >> 3); c++)
+    {
+        syndrome ^= xor_table[bits[c]] ^ (-parity_table[bits[c]] & (c << 3));
+    }
+    return syndrome;
+}
+
+// Embed k bits by flipping the LSB at the position the syndrome points to
+int matrix_embed_group(unsigned char message, char *buffer, int k)
+{
+    unsigned char d = matrix_syndrome(buffer, MATRIX_GROUP_SIZE(k)) ^ message;
+    int flip = (d != 0);
+
+    // d == 0 means the group already carries the message; touch byte 0 with a no-op
+    buffer[d - 1 + !flip] ^= flip;
+    return flip;
+}
+
+// Read k bits of data starting at bit, MSB first; bits past the end read as 0
+unsigned char matrix_message_bits(const char *data, uint size, unsigned long long bit, int k)
+{
+    unsigned char message = 0;
+    int i;
+    for (i = 0; i < k; i++, bit++)
+    {
+        unsigned char b = 0;
+        if ((bit >> 3) < size)
+        {
+            b = (data[bit >> 3] >> (7 - (bit & 7))) & 1;
+        }
+        message = (message << 1) | b;
+    }
+    return message;
+}
+
+// Embed data into consecutive groups of an in-memory cover region
+uint matrix_embed_buffer(const char *data, uint size, int k, char *cover)
+{
+    int n = MATRIX_GROUP_SIZE(k);
+    uint groups = matrix_group_count(k, size);
+    uint g, flips = 0;
+
+    for (g = 0; g < groups; g++)
+    {
+        flips += matrix_embed_group(matrix_message_bits(data, size, (unsigned long long)g * k, k), cover + (size_t)g * n, k);
+    }
+    return flips;
+}
+
+// Extract data from consecutive groups of an in-memory cover region
+void matrix_extract_buffer(const char *cover, uint size, int k, char *data)
+{
+    int n = MATRIX_GROUP_SIZE(k);
+    uint acc = 0, written = 0;
+    int nbits = 0;
+
+    while (written < size)
+    {
+        acc = (acc << k) | matrix_syndrome(cover, n);
+        cover += n;
+        nbits += k;
+        while (nbits >= 8 && written < size)
+        {
+            data[written++] = (acc >> (nbits - 8)) & 0xFF;
+            nbits -= 8;
+        }
+        acc &= (1u << nbits) - 1;
+    }
+}
+
+// Encode data group by group
+// Collect k re-extracted bits and check each payload byte as soon as all its bits are in, as the decoder rebuilds them
+void matrix_verify_group(VerifyInfo *verify, const char *data, uint size, unsigned char syndrome, int k)
+{
+    verify->matrix_acc = (verify->matrix_acc << k) | syndrome;
+    verify->matrix_bits += k;
+    while (verify->matrix_bits >= 8 && verify->matrix_checked < size)
+    {
+        char ch = (verify->matrix_acc >> (verify->matrix_bits - 8)) & 0xFF;
+        verify->matrix_bits -= 8;
+        verify_window(verify, &data[verify->matrix_checked++], &ch, 1);
+    }
+    verify->matrix_acc &= (1u << verify->matrix_bits) - 1;
+}
+
+Status encode_matrix_data_to_image(const char *data, uint size, int k, FILE *fptr_src_image, FILE *fptr_stego_image, VerifyInfo *verify)
+{
+    char buffer[MATRIX_GROUP_SIZE(MATRIX_MAX_K)];
+    int n = MATRIX_GROUP_SIZE(k);
+    uint groups = matrix_group_count(k, size);
+    uint g, flips = 0;
+
+    for (g = 0; g < groups; g++)
+    {
+        if (fread(buffer, n, 1, fptr_src_image) != 1)
+        {
+            printf("ERROR: ❌ Failed to read source image while matrix encoding data\n");
+            return e_failure;
+        }
+        flips += matrix_embed_group(matrix_message_bits(data, size, (unsigned long long)g * k, k), buffer, k);
+        if (verify != NULL)
+        {
+            // Re-extract the group as the decoder will
+            matrix_verify_group(verify, data, size, matrix_syndrome(buffer, n), k);
+        }
+        if (fwrite(buffer, n, 1, fptr_stego_image) != 1)
+        {
+            fprintf(stderr, "ERROR: ❌ Failed to write matrix encoded data to destination image\n");
+            return e_failure;
+        }
+    }
+    printf("[INFO] Matrix embedding (k = %d) modified %u of %u cover bytes\n", k, flips, groups * n);
+    return e_success;
+}
+
+// Decode data group by group, writing each byte once all its bits are in
+Status decode_matrix_data_from_image(uint size, int k, FILE *fptr_stego_image, FILE *fptr_out, uint *crc)
+{
+    char buffer[MATRIX_GROUP_SIZE(MATRIX_MAX_K)];
+    int n = MATRIX_GROUP_SIZE(k);
+    uint acc = 0, written = 0;
+    int nbits = 0;
+
+    while (written < size)
+    {
+        if (fread(buffer, n, 1, fptr_stego_image) != 1)
+        {
+            printf("ERROR: ❌ Failed to read stego image while matrix decoding data\n");
+            return e_failure;
+        }
+        acc = (acc << k) | matrix_syndrome(buffer, n);
+        nbits += k;
+        while (nbits >= 8 && written < size)
+        {
+            char ch = (acc >> (nbits - 8)) & 0xFF;
+            nbits -= 8;
+            if (fwrite(&ch, 1, 1, fptr_out) != 1)
+            {
+                printf("ERROR: ❌ Failed to write matrix decoded data\n");
+                return e_failure;
+            }
+            *crc = crc32_update(*crc, &ch, 1);
+            written++;
+        }
+        acc &= (1u << nbits) - 1;
+    }
+    return e_success;
+}
@@ -0,0 +1,54 @@
+#ifndef MATRIX_H
+#define MATRIX_H
+
+#include <stdio.h>
+#include "types.h" // User-defined data types
+#include "checksum.h"
+
+/*
+ * Matrix (syndrome) embedding using the binary Hamming code (1, 2^k - 1, k).
+ * k message bits are carried by the LSBs of a group of n = 2^k - 1 cover
+ * bytes, and at most one LSB of the group is flipped to do so.
+ */
+
+#define MATRIX_MIN_K 1
+#define MATRIX_MAX_K 8
+#define MATRIX_AUTO (-1) // Pick the largest k the cover can hold
+
+/* Cover bytes in one group of the (1, 2^k - 1, k) code */
+#define MATRIX_GROUP_SIZE(k) ((1 << (k)) - 1)
+
+/* Number of k-bit groups needed to carry size bytes */
+uint matrix_group_count(int k, uint size);
+
+/* Number of cover bytes needed to carry size bytes */
+unsigned long long matrix_cover_bytes(int k, uint size);
+
+/* Pick the largest k whose groups for size bytes fit in avail cover bytes, 0 if none */
+int matrix_choose_k(unsigned long long avail, uint size);
+
+/* Syndrome of the LSBs of one group of n cover bytes */
+unsigned char matrix_syndrome(const char *buffer, int n);
+
+/* k bits of data starting at bit, MSB first, zero past the end */
+unsigned char matrix_message_bits(const char *data, uint size, unsigned long long bit, int k);
+
+/* Embed k message bits into one group, flipping at most one LSB; returns the flip count */
+int matrix_embed_group(unsigned char message, char *buffer, int k);
+
+/* Take the re-extracted syndrome of the next group and check the payload bytes it completes */
+void matrix_verify_group(VerifyInfo *verify, const char *data, uint size, unsigned char syndrome, int k);
+
+/* Embed size bytes of data into an in-memory cover region; returns the flip count */
+uint matrix_embed_buffer(const char *data, uint size, int k, char *cover);
+
+/* Extract size bytes of data from an in-memory cover region */
+void matrix_extract_buffer(const char *cover, uint size, int k, char *data);
+
+/* Encode size bytes of data into the stego image, one group at a time; verify may be NULL */
+Status encode_matrix_data_to_image(const char *data, uint size, int k, FILE *fptr_src_image, FILE *fptr_stego_image, VerifyInfo *verify);
+
+/* Decode size bytes of data from the stego image into fptr_out, updating *crc */
+Status decode_matrix_data_from_image(uint size, int k, FILE *fptr_stego_image, FILE *fptr_out, uint *crc);
+
+#endif
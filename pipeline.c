@@ -0,0 +1,580 @@
+/*
+Documentation
+Name       :G Gangadhar
+Date       :30/07/2025
+Description:Steganography project
+*/
+#define _GNU_SOURCE // sync_file_range
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <pthread.h>
+#include <unistd.h>
+#include "arena.h"
+#include "async.h"
+#include "checksum.h"
+#include "common.h"
+#include "decode.h"
+#include "encode.h"
+#include "journal.h"
+#include "lsb.h"
+#include "matrix.h"
+#include "pipeline.h"
+#include "plan.h"
+#include "ring.h"
+#include "types.h"
+
+/* Embed stage state */
+typedef struct _EmbedCtx
+{
+    EmbedPlan plan;
+    VerifyInfo *verify;
+} EmbedCtx;
+
+/* Extract stage state, carried from block to block */
+typedef struct _ExtractCtx
+{
+    EmbedPlan plan; // Only used to align blocks to units
+    int k;          // 0 = plain LSB, else matrix code parameter
+    uint size;      // Data bytes to extract
+    uint written;   // Data bytes extracted so far
+    uint acc;       // Matrix bits not yet forming a byte
+    int nbits;
+    uint crc;
+} ExtractCtx;
+
+// Worker stage: pass blocks from filled to worked, running the middle stage
+static void *worker_stage(void *arg)
+{
+    Pipeline *pl = arg;
+    PipeBlock *block;
+    do
+    {
+        block = ring_pop(&pl->filled);
+        if (!atomic_load(&pl->failed) && pl->work(pl->ctx, block) == e_failure)
+        {
+            atomic_store(&pl->failed, 1);
+        }
+        ring_push(&pl->worked, block);
+    } while (!block->last);
+    return NULL;
+}
+
+// Keep the output CRC and commit a checkpoint once enough was written since the last one
+static void checkpoint(Pipeline *pl, PipeBlock *block, const char *data, size_t len)
+{
+    Journal *journal = pl->journal;
+    pl->out_crc = crc32_update(pl->out_crc, data, len);
+    if (block->last || (unsigned long long)(pl->out_offset - journal->last) < journal->interval)
+    {
+        return;
+    }
+    journal->in_offset = block->offset + block->len;
+    journal->out_offset = pl->out_offset;
+    journal->out_crc = pl->out_crc;
+    memcpy(journal->state, block->state, sizeof(journal->state));
+    if (journal_commit(journal, pl->out) == e_failure)
+    {
+        fprintf(stderr, "[INFO] Checkpoint at %lld not recorded\n", pl->out_offset);
+    }
+}
+
+// Start writeback of each finished half window and drop the previous one once it is on disk
+static void stream_output(Pipeline *pl, long long *prev, long long *flushed)
+{
+    int fd = fileno(pl->out);
+
+    if (pl->out_offset - *flushed < pl->window / 2 || fflush(pl->out) != 0)
+    {
+        return;
+    }
+    sync_file_range(fd, *flushed, pl->out_offset - *flushed, SYNC_FILE_RANGE_WRITE);
+    if (*prev < *flushed)
+    {
+        sync_file_range(fd, *prev, *flushed - *prev,
+                        SYNC_FILE_RANGE_WAIT_BEFORE | SYNC_FILE_RANGE_WRITE | SYNC_FILE_RANGE_WAIT_AFTER);
+        posix_fadvise(fd, *prev, *flushed - *prev, POSIX_FADV_DONTNEED);
+    }
+    *prev = *flushed;
+    *flushed = pl->out_offset;
+}
+
+// Write one worked block, count progress, checkpoint and stream the output
+static void write_block(Pipeline *pl, PipeBlock *block)
+{
+    char *data = block->out != NULL ? block->out : block->data;
+    size_t len = block->out != NULL ? block->out_len : block->len;
+
+    if (atomic_load(&pl->failed))
+    {
+        return;
+    }
+    if (len > 0 && fwrite(data, len, 1, pl->out) != 1)
+    {
+        fprintf(stderr, "ERROR: ❌ Pipeline failed to write %zu bytes\n", len);
+        atomic_store(&pl->failed, 1);
+    }
+    pl->bytes_out += len;
+    pl->out_offset += len;
+    if (pl->control != NULL)
+    {
+        atomic_store(&pl->control->done, pl->progress(pl->ctx, block->offset + block->len) - pl->progress(pl->ctx, pl->offset));
+    }
+    if (pl->journal != NULL)
+    {
+        checkpoint(pl, block, data, len);
+    }
+    if (pl->window > 0)
+    {
+        stream_output(pl, &pl->out_prev, &pl->out_flushed);
+    }
+}
+
+// Writer stage: write worked blocks and hand them back to the reader
+static void *writer_stage(void *arg)
+{
+    Pipeline *pl = arg;
+    PipeBlock *block;
+    do
+    {
+        block = ring_pop(&pl->worked);
+        write_block(pl, block);
+        ring_push(&pl->free, block);
+    } while (!block->last);
+    return NULL;
+}
+
+// Keep about one window of input read ahead of offset and drop what was consumed behind it
+static void stream_input(Pipeline *pl, long long offset, long long *ahead, long long *dropped)
+{
+    int fd = fileno(pl->in);
+
+    if (offset + pl->window / 2 >= *ahead)
+    {
+        posix_fadvise(fd, *ahead, pl->window, POSIX_FADV_WILLNEED);
+        *ahead += pl->window;
+    }
+    if (offset - *dropped >= pl->window / 2)
+    {
+        posix_fadvise(fd, *dropped, offset - *dropped, POSIX_FADV_DONTNEED);
+        *dropped = offset;
+    }
+}
+
+void pipeline_set_budget(Pipeline *pl, uint block_kb, uint mem_mb)
+{
+    unsigned long long kb = ((unsigned long long)mem_mb << 10) / 2 / PIPELINE_DEPTH;
+
+    pl->window = 0;
+    if (mem_mb == 0)
+    {
+        pl->block_size = (size_t)block_kb << 10;
+        return;
+    }
+    if (kb < PIPELINE_MIN_BLOCK_KB)
+    {
+        kb = PIPELINE_MIN_BLOCK_KB;
+    }
+    if (kb > PIPELINE_MAX_BLOCK_KB)
+    {
+        kb = PIPELINE_MAX_BLOCK_KB;
+    }
+    pl->block_size = kb << 10;
+    pl->window = (long long)mem_mb << 18; // A quarter of the budget each way
+    printf("[INFO] Memory budget %u MB: %llu KB blocks, %lld KB page cache windows\n", mem_mb, kb, pl->window >> 10);
+}
+
+// Fill a block from the input at *offset; returns whether it is the last one
+static int read_block(Pipeline *pl, PipeBlock *block, long long *offset)
+{
+    size_t want = pl->block_size;
+    size_t n = 0;
+    int last;
+
+    if (pl->end >= 0 && *offset + (long long)want > pl->end)
+    {
+        want = pl->end - *offset;
+    }
+    if (pl->align != NULL && want > 0)
+    {
+        want = pl->align(pl->ctx, *offset, want);
+    }
+    if (!atomic_load(&pl->failed) && job_control_should_stop(pl->control))
+    {
+        fprintf(stderr, "ERROR: ❌ Job cancelled or past its deadline at offset %lld\n", *offset);
+        atomic_store(&pl->failed, 1);
+    }
+    if (pl->window > 0)
+    {
+        stream_input(pl, *offset, &pl->in_ahead, &pl->in_dropped);
+    }
+    if (!atomic_load(&pl->failed) && want > 0)
+    {
+        n = fread(block->data, 1, want, pl->in);
+        if (n < want && ferror(pl->in))
+        {
+            fprintf(stderr, "ERROR: ❌ Pipeline failed to read at offset %lld\n", *offset);
+            atomic_store(&pl->failed, 1);
+        }
+    }
+    block->len = n;
+    block->out_len = 0;
+    block->offset = *offset;
+    *offset += n;
+    pl->bytes_in += n;
+    last = n < want || want == 0 || atomic_load(&pl->failed) || (pl->end >= 0 && *offset >= pl->end);
+    block->last = last;
+    return last;
+}
+
+// One block at a time through all three stages on the calling thread
+static void run_inline(Pipeline *pl, PipeBlock *block)
+{
+    long long offset = pl->offset;
+    int last = 0;
+
+    while (!last)
+    {
+        last = read_block(pl, block, &offset);
+        if (!atomic_load(&pl->failed) && pl->work(pl->ctx, block) == e_failure)
+        {
+            atomic_store(&pl->failed, 1);
+        }
+        write_block(pl, block);
+    }
+}
+
+// Reader stage runs on the calling thread; the other two get their own
+Status pipeline_run(Pipeline *pl)
+{
+    PipeBlock blocks[PIPELINE_DEPTH];
+    pthread_t worker, writer;
+    long long offset = pl->offset;
+    Status status = e_success;
+    // An executor job already has a worker thread to itself, so it runs the stages in turn on it
+    int depth = pl->control != NULL ? 1 : PIPELINE_DEPTH;
+    int i, last = 0;
+
+    memset(blocks, 0, sizeof(blocks));
+    atomic_init(&pl->failed, 0);
+    pl->bytes_in = pl->bytes_out = 0;
+    pl->in_ahead = pl->in_dropped = pl->offset;
+    pl->out_prev = pl->out_flushed = pl->out_offset;
+    if (pl->control != NULL)
+    {
+        atomic_store(&pl->control->done, 0);
+        atomic_store(&pl->control->total, pl->progress(pl->ctx, LLONG_MAX) - pl->progress(pl->ctx, pl->offset));
+    }
+    if (ring_init(&pl->free, PIPELINE_DEPTH) == e_failure || ring_init(&pl->filled, PIPELINE_DEPTH) == e_failure ||
+        ring_init(&pl->worked, PIPELINE_DEPTH) == e_failure)
+    {
+        status = e_failure;
+        goto out;
+    }
+    for (i = 0; i < depth; i++)
+    {
+        blocks[i].data = arena_alloc(pl->block_size + PIPELINE_BLOCK_SLACK);
+        blocks[i].out = pl->out_block_size ? arena_alloc(pl->out_block_size) : NULL;
+        if (blocks[i].data == NULL || (pl->out_block_size && blocks[i].out == NULL))
+        {
+            fprintf(stderr, "ERROR: ❌ Out of memory for pipeline blocks\n");
+            status = e_failure;
+            goto out;
+        }
+        ring_push(&pl->free, &blocks[i]);
+    }
+    posix_fadvise(fileno(pl->in), pl->offset, 0, POSIX_FADV_SEQUENTIAL);
+    if (depth == 1)
+    {
+        run_inline(pl, &blocks[0]);
+        status = atomic_load(&pl->failed) ? e_failure : e_success;
+        goto out;
+    }
+
+    if (pthread_create(&worker, NULL, worker_stage, pl) != 0)
+    {
+        status = e_failure;
+        goto out;
+    }
+    if (pthread_create(&writer, NULL, writer_stage, pl) != 0)
+    {
+        // Nothing can drain the worker; tell it to stop and wait for it
+        PipeBlock *block = ring_pop(&pl->free);
+        block->len = 0;
+        block->last = 1;
+        ring_push(&pl->filled, block);
+        pthread_join(worker, NULL);
+        status = e_failure;
+        goto out;
+    }
+
+    while (!last)
+    {
+        PipeBlock *block = ring_pop(&pl->free);
+        last = read_block(pl, block, &offset);
+        ring_push(&pl->filled, block);
+    }
+    pthread_join(worker, NULL);
+    pthread_join(writer, NULL);
+    if (atomic_load(&pl->failed))
+    {
+        status = e_failure;
+    }
+
+out:
+    for (i = 0; i < PIPELINE_DEPTH; i++)
+    {
+        arena_free(blocks[i].data);
+        arena_free(blocks[i].out);
+    }
+    ring_free(&pl->free);
+    ring_free(&pl->filled);
+    ring_free(&pl->worked);
+    return status;
+}
+
+// Without --resume there is no journal; with it, position input and output at the checkpoint if there is a usable one
+static Status setup_journal(Pipeline *pl, Journal *journal, int resume, int *resumed)
+{
+    long long out_start = ftell(pl->out);
+    Journal fresh;
+
+    *resumed = 0;
+    pl->journal = NULL;
+    pl->out_offset = out_start;
+    pl->out_crc = 0;
+    if (!resume)
+    {
+        return e_success;
+    }
+    // Checkpoints sync and truncate the output, which needs a real file
+    if (out_start < 0 || fileno(pl->out) < 0)
+    {
+        fprintf(stderr, "ERROR: ❌ --resume needs an output file\n");
+        return e_failure;
+    }
+
+    journal->out_start = journal->last = out_start;
+    fresh = *journal;
+    if (journal_resume(journal, pl->out) == e_success && journal->out_start == out_start &&
+        journal->in_offset >= pl->offset && (pl->end < 0 || journal->in_offset <= pl->end))
+    {
+        pl->offset = journal->in_offset;
+        pl->out_offset = journal->out_offset;
+        pl->out_crc = journal->out_crc;
+        *resumed = 1;
+    }
+    else
+    {
+        *journal = fresh;
+    }
+
+    // Whatever was written after the checkpoint is redone; a fresh output is empty already
+    fflush(pl->out);
+    if (fseek(pl->in, pl->offset, SEEK_SET) != 0 || fseek(pl->out, pl->out_offset, SEEK_SET) != 0)
+    {
+        perror("fseek");
+        return e_failure;
+    }
+    if (ftruncate(fileno(pl->out), pl->out_offset) != 0)
+    {
+        perror("ftruncate");
+        return e_failure;
+    }
+    pl->journal = journal;
+    return e_success;
+}
+
+// Block alignment through the plan
+static size_t align_to_plan(void *ctx, long long offset, size_t want)
+{
+    return plan_align_block(ctx, offset, want);
+}
+
+// Progress through the plan
+static unsigned long long payload_before(void *ctx, long long end)
+{
+    return plan_bytes_before(ctx, end);
+}
+
+// Embed stage
+static Status embed_work(void *ctx, PipeBlock *block)
+{
+    EmbedCtx *embed = ctx;
+    plan_embed_block(&embed->plan, block->offset, block->data, block->len, embed->verify);
+    return e_success;
+}
+
+// Extract stage: plain bytes or matrix groups, carrying partial bytes across blocks
+static Status extract_work(void *ctx, PipeBlock *block)
+{
+    ExtractCtx *ex = ctx;
+    int unit = PLAN_UNIT_SIZE(ex->k);
+    size_t pos;
+
+    block->out_len = 0;
+    if (ex->k == 0)
+    {
+        // Plain bytes need no carry; the LSB kernel takes the whole block
+        size_t n = block->len / unit < ex->size - ex->written ? block->len / unit : ex->size - ex->written;
+        lsb_extract(block->data, n, block->out);
+        block->out_len = n;
+        ex->written += n;
+    }
+    for (pos = 0; ex->k != 0 && pos + unit <= block->len && ex->written < ex->size; pos += unit)
+    {
+        ex->acc = (ex->acc << ex->k) | matrix_syndrome(block->data + pos, unit);
+        ex->nbits += ex->k;
+        while (ex->nbits >= 8 && ex->written < ex->size)
+        {
+            block->out[block->out_len++] = (ex->acc >> (ex->nbits - 8)) & 0xFF;
+            ex->nbits -= 8;
+            ex->written++;
+        }
+        ex->acc &= (1u << ex->nbits) - 1;
+    }
+    ex->crc = crc32_update(ex->crc, block->out, block->out_len);
+
+    // Everything a resumed decode needs to carry on after this block
+    block->state[0] = ex->written;
+    block->state[1] = ex->acc;
+    block->state[2] = ex->nbits;
+    block->state[3] = ex->crc;
+    return e_success;
+}
+
+// Encode everything after the header through the pipeline
+Status encode_secret_file_data_pipelined(EncodeInfo *encInfo)
+{
+    Pipeline pl;
+    Journal journal;
+    EmbedCtx *embed = arena_alloc(sizeof(EmbedCtx));
+    char *secret = arena_alloc(encInfo->size_secret_file + 1);
+    char params[PATH_MAX + 64];
+    Status status = e_failure;
+    int resumed;
+
+    if (embed == NULL || secret == NULL)
+    {
+        fprintf(stderr, "ERROR: ❌ Out of memory for the secret file\n");
+        goto out;
+    }
+    rewind(encInfo->fptr_secret);
+    if (encInfo->size_secret_file > 0 && fread(secret, encInfo->size_secret_file, 1, encInfo->fptr_secret) != 1)
+    {
+        fprintf(stderr, "ERROR: ❌ Failed to read %d bytes from secret file.\n", encInfo->size_secret_file);
+        goto out;
+    }
+    encInfo->secret_crc = crc32_update(0, secret, encInfo->size_secret_file);
+    plan_build(encInfo, secret, &embed->plan);
+    embed->verify = get_verify_info(encInfo);
+
+    // The header is already written; pick up right after it
+    memset(&pl, 0, sizeof(pl));
+    pl.in = encInfo->fptr_src_image;
+    pl.out = encInfo->fptr_stego_image;
+    pl.offset = ftell(encInfo->fptr_src_image);
+    pl.end = -1;
+    pipeline_set_budget(&pl, encInfo->block_kb, encInfo->mem_mb);
+    pl.align = align_to_plan;
+    pl.progress = payload_before;
+    pl.work = embed_work;
+    pl.ctx = embed;
+    pl.control = encInfo->control;
+    if (pl.offset != embed->plan.seg[1].start)
+    {
+        fprintf(stderr, "ERROR: ❌ Header ended at %ld, expected %lld\n", (long)pl.offset, embed->plan.seg[1].start);
+        goto out;
+    }
+
+    // The plan places every unit by cover offset, so any committed block end is a valid restart point
+    snprintf(params, sizeof(params), "encode %s flags=%d extn=%s", encInfo->stego_image_fname,
+             get_encode_flags(encInfo), encInfo->extn_secret_file);
+    journal_init(&journal, encInfo->stego_image_fname, journal_key(encInfo->src_image_fname, encInfo->secret_fname, params),
+                 encInfo->checkpoint_mb);
+    if (setup_journal(&pl, &journal, encInfo->resume, &resumed) == e_failure)
+    {
+        goto out;
+    }
+    status = pipeline_run(&pl);
+    if (status == e_success && encInfo->resume)
+    {
+        journal_remove(encInfo->stego_image_fname);
+    }
+    printf("[INFO] Pipelined %llu bytes in %zu KB blocks\n", pl.bytes_out, pl.block_size >> 10);
+
+out:
+    arena_free(secret);
+    arena_free(embed);
+    return status;
+}
+
+// Decode the data region through the pipeline; the trailer stays for decode_secret_file_crc
+Status decode_secret_file_data_pipelined(DecodeInfo *decInfo)
+{
+    Pipeline pl;
+    Journal journal;
+    ExtractCtx *ex = arena_alloc(sizeof(ExtractCtx));
+    char params[sizeof(decInfo->secret_fname) + 32];
+    Status status;
+    int resumed;
+
+    if (ex == NULL)
+    {
+        return e_failure;
+    }
+    memset(ex, 0, sizeof(ExtractCtx));
+    if (decInfo->stego_flags & FLAG_MATRIX)
+    {
+        ex->k = (decInfo->stego_flags & FLAG_MATRIX_K_MASK) >> FLAG_MATRIX_K_SHIFT;
+    }
+    ex->size = decInfo->size_secret_file;
+
+    memset(&pl, 0, sizeof(pl));
+    pl.in = decInfo->fptr_stego_image;
+    pl.out = decInfo->fptr_secret;
+    pl.offset = ftell(decInfo->fptr_stego_image);
+    plan_add_segment(&ex->plan, pl.offset, NULL, ex->size, ex->k);
+    pl.end = ex->plan.end;
+    pipeline_set_budget(&pl, decInfo->block_kb, decInfo->mem_mb);
+    pl.out_block_size = pl.block_size / 8 + PIPELINE_BLOCK_SLACK;
+    pl.align = align_to_plan;
+    pl.progress = payload_before;
+    pl.work = extract_work;
+    pl.ctx = ex;
+    pl.control = decInfo->control;
+
+    // The output grows while the job runs, so only its name goes into the key
+    snprintf(params, sizeof(params), "decode %s flags=%d", decInfo->secret_fname, decInfo->stego_flags);
+    journal_init(&journal, decInfo->secret_fname, journal_key(decInfo->stego_image_fname, NULL, params),
+                 decInfo->checkpoint_mb);
+    if (setup_journal(&pl, &journal, decInfo->resume, &resumed) == e_failure)
+    {
+        arena_free(ex);
+        return e_failure;
+    }
+    if (resumed)
+    {
+        ex->written = journal.state[0];
+        ex->acc = journal.state[1];
+        ex->nbits = journal.state[2];
+        ex->crc = journal.state[3];
+    }
+
+    status = pipeline_run(&pl);
+    if (status == e_success && decInfo->resume)
+    {
+        journal_remove(decInfo->secret_fname);
+    }
+    if (status == e_success && ex->written != ex->size)
+    {
+        printf("ERROR: ❌ Decoded %u of %u bytes from %s\n", ex->written, ex->size, decInfo->stego_image_fname);
+        status = e_failure;
+    }
+    decInfo->secret_crc = ex->crc;
+    printf("[INFO] Pipelined %llu bytes in %zu KB blocks\n", pl.bytes_in, pl.block_size >> 10);
+    arena_free(ex);
+    return status;
+}
@@ -0,0 +1,82 @@
+#ifndef PIPELINE_H
+#define PIPELINE_H
+
+#include <stdio.h>
+#include "decode.h" // DecodeInfo
+#include "encode.h" // EncodeInfo
+#include "journal.h" // Journal
+#include "ring.h"   // Ring
+#include "types.h"  // User-defined data types
+
+/*
+ * Three-stage read -> embed/extract -> write pipeline.
+ * A fixed pool of blocks cycles through three SPSC rings (free, filled,
+ * worked), so disk reads, the LSB work and disk writes overlap and a slow
+ * stage holds the others back once the pool is used up.
+ *
+ * Under a memory budget (--mem-mb) the cover is streamed in bounded
+ * windows: half of the budget goes to the block pool and the rest to the
+ * page cache, where the reader asks for one window ahead and drops what
+ * it has consumed, and the writer starts writeback of each finished
+ * window and drops it once it is on disk.
+ */
+
+#define PIPELINE_DEPTH 8
+#define PIPELINE_DEFAULT_BLOCK_KB 256
+#define PIPELINE_MAX_BLOCK_KB (64 * 1024)
+#define PIPELINE_BLOCK_SLACK 256 // Room for a block stretched to a whole unit
+#define PIPELINE_MIN_BLOCK_KB 16
+
+typedef struct _PipeBlock
+{
+    char *data;       // Bytes read from the input
+    size_t len;       // Valid bytes in data
+    char *out;        // Bytes to write when the stage makes a new stream, else NULL
+    size_t out_len;   // Valid bytes in out
+    long long offset; // Input offset of data[0]
+    int last;         // No block follows this one
+    unsigned long long state[JOURNAL_STATE_WORDS]; // Middle stage state after this block
+} PipeBlock;
+
+typedef struct _Pipeline
+{
+    FILE *in;                   // Read by the reader stage
+    FILE *out;                  // Written by the writer stage
+    long long offset;           // Input offset of the first block
+    long long end;              // Input offset to stop at, -1 for end of file
+    size_t block_size;          // Bytes per block
+    size_t out_block_size;      // Bytes per output buffer, 0 to write blocks in place
+    long long window;           // Page cache bytes per file under a memory budget, 0 for no bound
+    long long in_ahead;         // Input offset read ahead up to
+    long long in_dropped;       // Input offset dropped from the page cache up to
+    long long out_prev;         // Output offset written back and dropped up to
+    long long out_flushed;      // Output offset whose writeback was started up to
+    size_t (*align)(void *ctx, long long offset, size_t want); // Block length, NULL for fixed
+    Status (*work)(void *ctx, PipeBlock *block);               // Middle stage
+    unsigned long long (*progress)(void *ctx, long long end);  // Payload bytes done once the input before end is, for control
+    void *ctx;
+    struct _JobControl *control; // Stop on cancel or deadline and count progress, NULL for none; runs the stages on the calling thread
+    Journal *journal;           // Checkpoints every journal->interval output bytes, NULL for none
+    long long out_offset;       // Output offset of the next write
+    uint out_crc;               // CRC-32 of the output since journal->out_start
+    Ring free;                  // writer -> reader
+    Ring filled;                // reader -> worker
+    Ring worked;                // worker -> writer
+    _Atomic int failed;         // Set by any stage; the others drain and stop
+    unsigned long long bytes_in;
+    unsigned long long bytes_out;
+} Pipeline;
+
+/* Size blocks and page cache windows to fit in mem_mb; 0 keeps block_kb and leaves caching to the kernel */
+void pipeline_set_budget(Pipeline *pl, uint block_kb, uint mem_mb);
+
+/* Run the three stages until the input is consumed */
+Status pipeline_run(Pipeline *pl);
+
+/* Encode secret data, checksum trailer and left over image data through the pipeline */
+Status encode_secret_file_data_pipelined(EncodeInfo *encInfo);
+
+/* Decode secret data through the pipeline */
+Status decode_secret_file_data_pipelined(DecodeInfo *decInfo);
+
+#endif
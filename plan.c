@@ -0,0 +1,163 @@
+/*
+Documentation
+Name       :G Gangadhar
+Date       :30/07/2025
+Description:Steganography project
+*/
+#include <stdio.h>
+#include <string.h>
+#include "checksum.h"
+#include "common.h"
+#include "decode.h"
+#include "encode.h"
+#include "lsb.h"
+#include "matrix.h"
+#include "plan.h"
+#include "types.h"
+
+// Store an integer MSB first, the order encode_int_to_lsb writes its bits in
+static void put_be32(char *p, uint value)
+{
+    p[0] = value >> 24;
+    p[1] = value >> 16;
+    p[2] = value >> 8;
+    p[3] = value;
+}
+
+// Append a segment right where the payload currently ends
+void plan_add_segment(EmbedPlan *plan, long long start, const char *data, uint size, int k)
+{
+    PlanSegment *seg = &plan->seg[plan->count++];
+    seg->start = start;
+    seg->data = data;
+    seg->size = size;
+    seg->k = k;
+    seg->bytes = k ? matrix_cover_bytes(k, size) : (long long)size * 8;
+    plan->end = start + seg->bytes;
+}
+
+// Same byte layout as the stepwise encoder: header, data, optional checksum
+Status plan_build(EncodeInfo *encInfo, const char *secret, EmbedPlan *plan)
+{
+    uint extn_size = strlen(encInfo->extn_secret_file);
+    uint len = 0;
+
+    memset(plan, 0, sizeof(*plan));
+    memcpy(plan->header, MAGIC_STRING, strlen(MAGIC_STRING));
+    len += strlen(MAGIC_STRING);
+    put_be32(plan->header + len, extn_size | (get_encode_flags(encInfo) << FLAGS_SHIFT));
+    len += 4;
+    memcpy(plan->header + len, encInfo->extn_secret_file, extn_size);
+    len += extn_size;
+    put_be32(plan->header + len, encInfo->size_secret_file);
+    len += 4;
+
+    plan_add_segment(plan, 54, plan->header, len, 0);
+    plan_add_segment(plan, plan->end, secret, encInfo->size_secret_file, encInfo->matrix_k > 0 ? encInfo->matrix_k : 0);
+    if (encInfo->verify)
+    {
+        put_be32(plan->trailer, encInfo->secret_crc);
+        plan_add_segment(plan, plan->end, plan->trailer, 4, 0);
+    }
+    return e_success;
+}
+
+// Pull the block end back to the start of the unit it cuts through
+size_t plan_align_block(const EmbedPlan *plan, long long offset, size_t want)
+{
+    long long end = offset + want;
+    int i;
+    for (i = 0; i < plan->count; i++)
+    {
+        const PlanSegment *seg = &plan->seg[i];
+        if (end > seg->start && end < seg->start + seg->bytes)
+        {
+            long long unit = PLAN_UNIT_SIZE(seg->k);
+            long long cut = seg->start + (end - seg->start) / unit * unit;
+            if (cut > offset)
+            {
+                return cut - offset;
+            }
+            // Block smaller than one unit: stretch it to the unit's end
+            return cut + unit - offset;
+        }
+    }
+    return want;
+}
+
+// Re-extract a run of plain units and compare it with the payload
+static void verify_run(VerifyInfo *verify, const char *data, const char *buffer, size_t n)
+{
+    char check[256];
+    size_t i, m;
+    for (i = 0; i < n; i += m)
+    {
+        m = n - i < sizeof(check) ? n - i : sizeof(check);
+        lsb_extract(buffer + i * 8, m, check);
+        verify_window(verify, data + i, check, m);
+    }
+}
+
+// Whole units covered in each segment, as payload bytes
+unsigned long long plan_bytes_before(const EmbedPlan *plan, long long end)
+{
+    unsigned long long bytes = 0;
+    int i;
+    for (i = 0; i < plan->count; i++)
+    {
+        const PlanSegment *seg = &plan->seg[i];
+        long long covered = end - seg->start;
+        unsigned long long done;
+        if (covered <= 0)
+        {
+            continue;
+        }
+        covered = covered < seg->bytes ? covered : seg->bytes;
+        done = (unsigned long long)(covered / PLAN_UNIT_SIZE(seg->k)) * (seg->k ? seg->k : 8) / 8;
+        bytes += done < seg->size ? done : seg->size;
+    }
+    return bytes;
+}
+
+// Embed the units of every segment that falls inside the block
+void plan_embed_block(const EmbedPlan *plan, long long offset, char *block, size_t len, VerifyInfo *verify)
+{
+    long long block_end = offset + len;
+    int i;
+
+    for (i = 0; i < plan->count; i++)
+    {
+        const PlanSegment *seg = &plan->seg[i];
+        long long unit = PLAN_UNIT_SIZE(seg->k);
+        long long seg_end = seg->start + seg->bytes;
+        long long pos = offset > seg->start ? offset : seg->start;
+
+        if (seg->k == 0)
+        {
+            // Plain units are back to back, so the whole run goes through the LSB kernel at once
+            long long last = block_end < seg_end ? block_end : seg_end;
+            if (pos + unit <= last)
+            {
+                size_t n = (last - pos) / unit;
+                lsb_embed(seg->data + (pos - seg->start) / unit, n, block + (pos - offset));
+                if (verify != NULL)
+                {
+                    verify_run(verify, seg->data + (pos - seg->start) / unit, block + (pos - offset), n);
+                }
+            }
+            continue;
+        }
+        for (; pos + unit <= block_end && pos + unit <= seg_end; pos += unit)
+        {
+            long long u = (pos - seg->start) / unit;
+            char *buffer = block + (pos - offset);
+            char message = matrix_message_bits(seg->data, seg->size, (unsigned long long)u * seg->k, seg->k);
+            matrix_embed_group(message, buffer, seg->k);
+            if (verify != NULL)
+            {
+                // Payload bytes, not syndromes, so the count and CRC match the stepwise path
+                matrix_verify_group(verify, seg->data, seg->size, matrix_syndrome(buffer, unit), seg->k);
+            }
+        }
+    }
+}
@@ -0,0 +1,55 @@
+#ifndef PLAN_H
+#define PLAN_H
+
+#include "checksum.h" // VerifyInfo
+#include "encode.h"   // EncodeInfo
+#include "matrix.h"   // MATRIX_GROUP_SIZE
+#include "types.h"    // User-defined data types
+
+/*
+ * Where every part of the payload lands in the cover, so a block of cover
+ * bytes can be embedded on its own, in any thread, without the stepwise
+ * FILE based encoder. Units (8 bytes per plain payload byte, or one
+ * matrix group) never straddle a block returned by plan_align_block.
+ */
+
+#define PLAN_MAX_SEGMENTS 3
+#define PLAN_HEADER_MAX 64
+
+typedef struct _PlanSegment
+{
+    long long start;  // Cover offset of the first unit
+    long long bytes;  // Cover bytes used by the segment
+    const char *data; // Payload bytes
+    uint size;        // Payload byte count
+    int k;            // 0 = plain LSB, else matrix code parameter
+} PlanSegment;
+
+typedef struct _EmbedPlan
+{
+    PlanSegment seg[PLAN_MAX_SEGMENTS];
+    int count;
+    long long end;                // First cover byte past the payload
+    char header[PLAN_HEADER_MAX]; // Magic, extension size and flags, extension, file size
+    char trailer[4];              // CRC-32 of the data when FLAG_CRC is set
+} EmbedPlan;
+
+/* Cover bytes of one unit of a segment */
+#define PLAN_UNIT_SIZE(k) ((k) ? MATRIX_GROUP_SIZE(k) : 8)
+
+/* Lay out header, data and trailer after the 54-byte BMP header */
+Status plan_build(EncodeInfo *encInfo, const char *secret, EmbedPlan *plan);
+
+/* Append a segment of size payload bytes starting at cover offset start */
+void plan_add_segment(EmbedPlan *plan, long long start, const char *data, uint size, int k);
+
+/* Largest block length up to want starting at offset that ends on a unit boundary */
+size_t plan_align_block(const EmbedPlan *plan, long long offset, size_t want);
+
+/* Payload bytes whose units all lie before cover offset end */
+unsigned long long plan_bytes_before(const EmbedPlan *plan, long long end);
+
+/* Embed every unit inside a block of cover bytes at cover offset offset */
+void plan_embed_block(const EmbedPlan *plan, long long offset, char *block, size_t len, VerifyInfo *verify);
+
+#endif
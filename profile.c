@@ -0,0 +1,183 @@
+/*
+Documentation
+Name       :G Gangadhar
+Date       :30/07/2025
+Description:Steganography project
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <limits.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "lsb.h"
+#include "pipeline.h"
+#include "profile.h"
+#include "types.h"
+
+static Profile host_profile;
+static pthread_once_t profile_once = PTHREAD_ONCE_INIT;
+
+Status profile_path(char *path, size_t size)
+{
+    const char *env = getenv(PROFILE_ENV_PATH);
+    const char *home = getenv("HOME");
+    char host[256];
+
+    if (env != NULL && env[0] != '\0')
+    {
+        snprintf(path, size, "%s", env);
+        return e_success;
+    }
+    if (home == NULL || gethostname(host, sizeof(host)) != 0)
+    {
+        return e_failure;
+    }
+    host[sizeof(host) - 1] = '\0';
+    snprintf(path, size, "%s/%s/profile-%s", home, PROFILE_DIR, host);
+    return e_success;
+}
+
+// Read "key value" lines; unknown keys and bad values leave the defaults
+static void load_profile(void)
+{
+    char path[PATH_MAX], line[128], key[32], value[64];
+    FILE *fptr;
+
+    snprintf(host_profile.embed, sizeof(host_profile.embed), "%s", lsb_embed_name());
+    snprintf(host_profile.extract, sizeof(host_profile.extract), "%s", lsb_extract_name());
+    host_profile.block_kb = PIPELINE_DEFAULT_BLOCK_KB;
+    if (profile_path(path, sizeof(path)) == e_failure || (fptr = fopen(path, "r")) == NULL)
+    {
+        return;
+    }
+    if (fgets(line, sizeof(line), fptr) == NULL || strncmp(line, PROFILE_VERSION, strlen(PROFILE_VERSION)) != 0)
+    {
+        printf("[INFO] Ignoring unreadable profile %s\n", path);
+        fclose(fptr);
+        return;
+    }
+    while (fgets(line, sizeof(line), fptr) != NULL)
+    {
+        if (sscanf(line, "%31s %63s", key, value) != 2)
+        {
+            continue;
+        }
+        if (strcmp(key, "embed") == 0 || strcmp(key, "extract") == 0)
+        {
+            char *name = strcmp(key, "embed") == 0 ? host_profile.embed : host_profile.extract;
+            if (strlen(value) < LSB_KERNEL_NAME_SIZE)
+            {
+                strcpy(name, value);
+            }
+        }
+        else if (strcmp(key, "block_kb") == 0 && atoi(value) >= PIPELINE_MIN_BLOCK_KB && atoi(value) <= PIPELINE_MAX_BLOCK_KB)
+        {
+            host_profile.block_kb = atoi(value);
+        }
+        else if (strcmp(key, "threads") == 0 && atoi(value) > 0)
+        {
+            host_profile.threads = atoi(value);
+        }
+    }
+    fclose(fptr);
+
+    // A profile from a build with other kernels keeps the defaults
+    if (lsb_select(host_profile.embed, host_profile.extract) == e_failure)
+    {
+        printf("[INFO] Profile kernels %s/%s are not built in; using %s/%s\n", host_profile.embed,
+               host_profile.extract, lsb_embed_name(), lsb_extract_name());
+        snprintf(host_profile.embed, sizeof(host_profile.embed), "%s", lsb_embed_name());
+        snprintf(host_profile.extract, sizeof(host_profile.extract), "%s", lsb_extract_name());
+    }
+    host_profile.loaded = 1;
+}
+
+const Profile *profile_load(void)
+{
+    pthread_once(&profile_once, load_profile);
+    return &host_profile;
+}
+
+// Create the default profile directory one level at a time
+static Status make_profile_dir(void)
+{
+    const char *env = getenv(PROFILE_ENV_PATH);
+    const char *home = getenv("HOME");
+    char dir[PATH_MAX], *slash;
+
+    if ((env != NULL && env[0] != '\0') || home == NULL)
+    {
+        return e_success;
+    }
+    snprintf(dir, sizeof(dir), "%s/%s", home, PROFILE_DIR);
+    for (slash = strchr(dir + strlen(home) + 1, '/');; slash = strchr(slash + 1, '/'))
+    {
+        if (slash != NULL)
+        {
+            *slash = '\0';
+        }
+        if (mkdir(dir, 0755) != 0 && errno != EEXIST)
+        {
+            perror("mkdir");
+            return e_failure;
+        }
+        if (slash == NULL)
+        {
+            break;
+        }
+        *slash = '/';
+    }
+    return e_success;
+}
+
+Status profile_save(const Profile *profile)
+{
+    char path[PATH_MAX], tmp_path[PATH_MAX + 16], host[256] = "unknown";
+    FILE *fptr;
+
+    if (profile_path(path, sizeof(path)) == e_failure || make_profile_dir() == e_failure)
+    {
+        printf("ERROR: ❌ No place for the profile; set %s\n", PROFILE_ENV_PATH);
+        return e_failure;
+    }
+    gethostname(host, sizeof(host));
+    host[sizeof(host) - 1] = '\0';
+    snprintf(tmp_path, sizeof(tmp_path), "%s.%ld.tmp", path, (long)getpid());
+    fptr = fopen(tmp_path, "w");
+    if (fptr == NULL)
+    {
+        perror("fopen");
+        fprintf(stderr, "ERROR: ❌Unable to open file %s\n", tmp_path);
+        return e_failure;
+    }
+    fprintf(fptr, "%s\nhost %s\nembed %s\nextract %s\nblock_kb %u\nthreads %d\n", PROFILE_VERSION, host,
+            profile->embed, profile->extract, profile->block_kb, profile->threads);
+    if (fclose(fptr) != 0 || rename(tmp_path, path) != 0)
+    {
+        perror("rename");
+        unlink(tmp_path);
+        return e_failure;
+    }
+    printf("[INFO] Profile written to %s\n", path);
+    return e_success;
+}
+
+uint profile_block_kb(void)
+{
+    return profile_load()->block_kb;
+}
+
+int profile_threads(int max)
+{
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    int threads = profile_load()->threads;
+
+    if (threads <= 0)
+    {
+        threads = cpus < 1 ? 1 : cpus;
+    }
+    return threads > max ? max : threads;
+}
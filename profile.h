@@ -0,0 +1,45 @@
+#ifndef PROFILE_H
+#define PROFILE_H
+
+#include <stddef.h>
+#include "lsb.h"   // LSB_KERNEL_NAME_SIZE
+#include "types.h" // User-defined data types
+
+/*
+ * Per-host runtime profile, written by the tune command: the LSB kernels,
+ * the pipeline block size and the worker thread count that measured best
+ * on this machine. It lives in $STEGO_PROFILE, else in
+ * ~/.config/stego/profile-<hostname>, so a home directory shared by many
+ * hosts keeps one profile each. Without a profile the built-in defaults
+ * apply; command line options still override it.
+ */
+
+#define PROFILE_ENV_PATH "STEGO_PROFILE"
+#define PROFILE_DIR ".config/stego"
+#define PROFILE_VERSION "# stego profile v1"
+
+typedef struct _Profile
+{
+    char embed[LSB_KERNEL_NAME_SIZE];   // LSB embed kernel
+    char extract[LSB_KERNEL_NAME_SIZE]; // LSB extract kernel
+    uint block_kb;                      // Pipeline block size
+    int threads;                        // Threads for CPU-bound pools, 0 for one per CPU
+    int loaded;                         // Read from a profile file
+} Profile;
+
+/* Path of this host's profile */
+Status profile_path(char *path, size_t size);
+
+/* Load this host's profile on first use and switch to its kernels */
+const Profile *profile_load(void);
+
+/* Write a profile for this host, creating its directory */
+Status profile_save(const Profile *profile);
+
+/* Pipeline block size from the profile, else PIPELINE_DEFAULT_BLOCK_KB */
+uint profile_block_kb(void);
+
+/* Thread count from the profile, else the CPU count, kept between 1 and max */
+int profile_threads(int max);
+
+#endif
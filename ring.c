@@ -0,0 +1,98 @@
+/*
+Documentation
+Name       :G Gangadhar
+Date       :30/07/2025
+Description:Steganography project
+*/
+#include <stdlib.h>
+#include <sched.h>
+#include "ring.h"
+#include "types.h"
+
+/* Busy polls before a waiting side gives up its time slice */
+#define RING_SPINS 64
+
+// Round the capacity up to a power of two so indexes wrap with a mask
+Status ring_init(Ring *ring, size_t capacity)
+{
+    size_t size = 1;
+    while (size < capacity)
+    {
+        size <<= 1;
+    }
+    ring->slots = calloc(size, sizeof(void *));
+    if (ring->slots == NULL)
+    {
+        return e_failure;
+    }
+    ring->mask = size - 1;
+    atomic_init(&ring->head, 0);
+    atomic_init(&ring->tail, 0);
+    return e_success;
+}
+
+// Free the slot array
+void ring_free(Ring *ring)
+{
+    free(ring->slots);
+    ring->slots = NULL;
+}
+
+// Producer side: publish the slot with a release store of the tail
+Status ring_try_push(Ring *ring, void *item)
+{
+    size_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+    size_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+    if (tail - head > ring->mask)
+    {
+        return e_failure;
+    }
+    ring->slots[tail & ring->mask] = item;
+    atomic_store_explicit(&ring->tail, tail + 1, memory_order_release);
+    return e_success;
+}
+
+// Consumer side: take the slot, then free it with a release store of the head
+void *ring_try_pop(Ring *ring)
+{
+    size_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    size_t tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+    void *item;
+    if (head == tail)
+    {
+        return NULL;
+    }
+    item = ring->slots[head & ring->mask];
+    atomic_store_explicit(&ring->head, head + 1, memory_order_release);
+    return item;
+}
+
+// Spin briefly, then yield, until there is room
+void ring_push(Ring *ring, void *item)
+{
+    int spins = 0;
+    while (ring_try_push(ring, item) == e_failure)
+    {
+        if (++spins >= RING_SPINS)
+        {
+            sched_yield();
+            spins = 0;
+        }
+    }
+}
+
+// Spin briefly, then yield, until an item arrives
+void *ring_pop(Ring *ring)
+{
+    void *item;
+    int spins = 0;
+    while ((item = ring_try_pop(ring)) == NULL)
+    {
+        if (++spins >= RING_SPINS)
+        {
+            sched_yield();
+            spins = 0;
+        }
+    }
+    return item;
+}
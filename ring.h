@@ -0,0 +1,41 @@
+#ifndef RING_H
+#define RING_H
+
+#include <stdatomic.h>
+#include <stddef.h>
+#include "types.h" // User-defined data types
+
+/*
+ * Single-producer/single-consumer lock-free ring of pointers.
+ * Head and tail are only ever written by one side each, so a push and a
+ * pop never contend on a lock; a full ring makes the producer wait,
+ * which is the backpressure between pipeline stages.
+ */
+
+typedef struct _Ring
+{
+    void **slots;
+    size_t mask;                // Capacity - 1, capacity is a power of two
+    _Atomic size_t head;        // Next slot to pop, written by the consumer
+    _Atomic size_t tail;        // Next slot to push, written by the producer
+} Ring;
+
+/* Allocate a ring holding at least capacity pointers */
+Status ring_init(Ring *ring, size_t capacity);
+
+/* Release the slots of a ring */
+void ring_free(Ring *ring);
+
+/* Push without waiting; e_failure if the ring is full */
+Status ring_try_push(Ring *ring, void *item);
+
+/* Pop without waiting; NULL if the ring is empty */
+void *ring_try_pop(Ring *ring);
+
+/* Push, yielding while the ring is full */
+void ring_push(Ring *ring, void *item);
+
+/* Pop, yielding while the ring is empty */
+void *ring_pop(Ring *ring);
+
+#endif
@@ -0,0 +1,258 @@
+/*
+Documentation
+Name       :G Gangadhar
+Date       :30/07/2025
+Description:Steganography project
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+#include "arena.h"
+#include "common.h"
+#include "decode.h"
+#include "matrix.h"
+#include "scan.h"
+#include "types.h"
+
+// Pack the LSB of every byte into a bitmap, bit i = LSB of byte i
+static void build_lsb_bitmap(const unsigned char *data, size_t len, unsigned char *bitmap)
+{
+    size_t i = 0;
+#ifdef __SSE2__
+    // Shift each LSB into the sign bit and gather 16 of them per movemask
+    for (; i + 16 <= len; i += 16)
+    {
+        __m128i v = _mm_loadu_si128((const __m128i *)(data + i));
+        unsigned short mask = _mm_movemask_epi8(_mm_slli_epi16(v, 7));
+        memcpy(bitmap + (i >> 3), &mask, 2);
+    }
+#endif
+    for (; i < len; i++)
+    {
+        bitmap[i >> 3] |= (data[i] & 1) << (i & 7);
+    }
+}
+
+// Read n bits MSB first from the LSB stream starting at bit
+static uint get_stream_bits(const unsigned char *bitmap, size_t bit, int n)
+{
+    uint value = 0;
+    int i;
+    for (i = 0; i < n; i++, bit++)
+    {
+        value = (value << 1) | ((bitmap[bit >> 3] >> (bit & 7)) & 1);
+    }
+    return value;
+}
+
+// Check that the fields after a magic hit describe a payload that fits in the file; total counts from bitmap bit 0
+static int plausible_payload(const unsigned char *bitmap, size_t len, size_t offset, unsigned long long total)
+{
+    size_t bit = offset + (sizeof(MAGIC_STRING) - 1) * 8;
+    uint field, extn_size, flags, i;
+    int k = 0;
+
+    if (bit + 32 > len)
+    {
+        return 0;
+    }
+    field = get_stream_bits(bitmap, bit, 32);
+    extn_size = field & EXTN_SIZE_MASK;
+    flags = field >> FLAGS_SHIFT;
+    bit += 32;
+    if (extn_size == 0 || extn_size > MAX_FILE_SUFFIX ||
+        (flags & ~(FLAG_MATRIX | FLAG_MATRIX_K_MASK | FLAG_CRC | FLAG_ADAPTIVE)) != 0)
+    {
+        return 0;
+    }
+    if (flags & FLAG_MATRIX)
+    {
+        k = (flags & FLAG_MATRIX_K_MASK) >> FLAG_MATRIX_K_SHIFT;
+        if (k < MATRIX_MIN_K || k > MATRIX_MAX_K)
+        {
+            return 0;
+        }
+    }
+    else if (flags & FLAG_MATRIX_K_MASK)
+    {
+        return 0;
+    }
+
+    // Extension: a dot followed by alphanumerics
+    if (bit + extn_size * 8 + 32 > len)
+    {
+        return 0;
+    }
+    for (i = 0; i < extn_size; i++, bit += 8)
+    {
+        uint ch = get_stream_bits(bitmap, bit, 8);
+        if (i == 0 ? ch != '.' : !((ch >= 'a' && ch <= 'z') || (ch >= 'A' && ch <= 'Z') || (ch >= '0' && ch <= '9')))
+        {
+            return 0;
+        }
+    }
+
+    // Size: the data and trailer must fit in what is left
+    uint size = get_stream_bits(bitmap, bit, 32);
+    bit += 32;
+    if (size > MAX_SECRET_SIZE)
+    {
+        return 0;
+    }
+    unsigned long long region = k ? matrix_cover_bytes(k, size) : (unsigned long long)size * 8;
+    if (flags & FLAG_CRC)
+    {
+        region += 32;
+    }
+    return bit + region <= total;
+}
+
+// Magic bit j as it appears in the LSB of cover byte j
+static int magic_bit(int j)
+{
+    return (MAGIC_STRING[j >> 3] >> (7 - (j & 7))) & 1;
+}
+
+// Does the magic start at offset?
+static int magic_at(const unsigned char *bitmap, size_t len, size_t offset)
+{
+    size_t nbits = (sizeof(MAGIC_STRING) - 1) * 8;
+    size_t j;
+    if (offset + nbits > len)
+    {
+        return 0;
+    }
+    for (j = 0; j < nbits; j++)
+    {
+        if ((int)get_stream_bits(bitmap, offset + j, 1) != magic_bit(j))
+        {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+// Bit-sliced search: one 64-bit word tests 64 consecutive start offsets at once
+static Status find_magic(const unsigned char *bitmap, size_t len, unsigned long long total, size_t *found)
+{
+    const int nbits = (sizeof(MAGIC_STRING) - 1) * 8;
+    size_t nwords = (len + 63) / 64;
+    size_t w;
+    int j;
+
+    for (w = 0; w < nwords; w++)
+    {
+        unsigned long long cand = ~0ULL;
+        unsigned long long lo, hi;
+        memcpy(&lo, bitmap + w * 8, 8);
+        memcpy(&hi, bitmap + w * 8 + 8, 8);
+
+        // Offset o matches when LSB(o + j) equals magic bit j for every j
+        for (j = 0; j < nbits && cand; j++)
+        {
+            unsigned long long b = j ? (lo >> j) | (hi << (64 - j)) : lo;
+            cand &= magic_bit(j) ? b : ~b;
+        }
+        while (cand)
+        {
+            size_t offset = w * 64 + __builtin_ctzll(cand);
+            cand &= cand - 1;
+            if (offset + SCAN_MIN_HEADER_BITS <= len && plausible_payload(bitmap, len, offset, total))
+            {
+                *found = offset;
+                return e_success;
+            }
+        }
+    }
+    return e_failure;
+}
+
+// Read len bytes at base and pack their LSB plane
+static Status load_window(int fd, long long base, size_t len, unsigned char *data, unsigned char *bitmap)
+{
+    size_t got = 0;
+    while (got < len)
+    {
+        ssize_t n = pread(fd, data + got, len - got, base + got);
+        if (n <= 0)
+        {
+            return e_failure;
+        }
+        got += n;
+    }
+    memset(bitmap, 0, len / 8 + 24);
+    build_lsb_bitmap(data, len, bitmap);
+    return e_success;
+}
+
+// Search the LSB plane of the image one bounded window at a time
+Status scan_for_payload(FILE *fptr_image, size_t window, long *offset)
+{
+    struct stat st;
+    unsigned char *data, *bitmap;
+    long long total, base, pixel_offset;
+    size_t len, found;
+    int fd = fileno(fptr_image);
+    Status status = e_failure;
+
+    fflush(fptr_image);
+    if (fstat(fd, &st) != 0 || st.st_size < (off_t)SCAN_MIN_HEADER_BITS)
+    {
+        return e_failure;
+    }
+    total = st.st_size;
+    window = window ? window : (size_t)SCAN_DEFAULT_WINDOW_MB << 20;
+    window = window > 2 * SCAN_MAX_HEADER_BITS ? window : 2 * SCAN_MAX_HEADER_BITS;
+    window = (long long)window < total ? window : (size_t)total;
+
+    // Padding past the end keeps the two-word loads in bounds
+    data = arena_alloc(window);
+    bitmap = arena_alloc(window / 8 + 24);
+    if (data == NULL || bitmap == NULL || pread(fd, data, 14, 0) != 14)
+    {
+        arena_free(data);
+        arena_free(bitmap);
+        return e_failure;
+    }
+    posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+
+    // The header's own pixel offset is the most likely place; try it first
+    pixel_offset = data[10] | (data[11] << 8) | (data[12] << 16) | ((long long)data[13] << 24);
+    len = total - pixel_offset < (long long)SCAN_MAX_HEADER_BITS ? (size_t)(total - pixel_offset) : (size_t)SCAN_MAX_HEADER_BITS;
+    if (pixel_offset < total && load_window(fd, pixel_offset, len, data, bitmap) == e_success &&
+        magic_at(bitmap, len, 0) && plausible_payload(bitmap, len, 0, total - pixel_offset))
+    {
+        *offset = pixel_offset;
+        status = e_success;
+    }
+
+    // Windows overlap by the longest header, so a hit near the end of one is tested whole in the next
+    for (base = 0; status == e_failure; base += window - SCAN_MAX_HEADER_BITS)
+    {
+        len = total - base < (long long)window ? (size_t)(total - base) : window;
+        if (load_window(fd, base, len, data, bitmap) == e_failure)
+        {
+            break;
+        }
+        if (find_magic(bitmap, len, total - base, &found) == e_success)
+        {
+            *offset = base + found;
+            status = e_success;
+        }
+        posix_fadvise(fd, base, len, POSIX_FADV_DONTNEED);
+        if (base + (long long)len >= total)
+        {
+            break;
+        }
+    }
+
+    arena_free(bitmap);
+    arena_free(data);
+    return status;
+}
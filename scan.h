@@ -0,0 +1,27 @@
+#ifndef SCAN_H
+#define SCAN_H
+
+#include <stdio.h>
+#include "types.h" // User-defined data types
+
+/*
+ * Recovery scan for payloads that do not start at byte 54, e.g. behind a
+ * V4/V5 header or extra metadata. The file is read in bounded windows and
+ * the LSB plane of each is packed into a bitmap 16 bytes at a time, then
+ * every byte offset is tested against MAGIC_STRING 64 offsets per step
+ * with bit-sliced compares, and hits are checked against the header
+ * fields after it.
+ */
+
+/* Smallest payload header: magic, extension size, one extension byte, file size */
+#define SCAN_MIN_HEADER_BITS ((sizeof(MAGIC_STRING) - 1 + 4 + 1 + 4) * 8)
+
+/* Longest payload header, the overlap between two windows */
+#define SCAN_MAX_HEADER_BITS ((sizeof(MAGIC_STRING) - 1 + 4 + MAX_FILE_SUFFIX + 4) * 8)
+
+#define SCAN_DEFAULT_WINDOW_MB 64
+
+/* Find the offset of a plausible payload in the image, reading window bytes at a time (0 for the default) */
+Status scan_for_payload(FILE *fptr_image, size_t window, long *offset);
+
+#endif
@@ -0,0 +1,407 @@
+/*
+Documentation
+Name       :G Gangadhar
+Date       :30/07/2025
+Description:Steganography project
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+#include "lsb.h"
+#include "pipeline.h"
+#include "profile.h"
+#include "tune.h"
+#include "types.h"
+
+static const uint block_sizes_kb[] = {64, 128, 256, 512, 1024, 4096};
+
+/* One thread's slice of the scaling round */
+typedef struct _TuneSlice
+{
+    const LsbKernel *kernel;
+    const char *data;
+    char *cover;
+    size_t n;
+} TuneSlice;
+
+static double now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// Cheap pseudo-random fill, so neither the kernels nor the disk see a pattern
+static void fill_random(char *buffer, size_t len, unsigned long long seed)
+{
+    size_t i;
+    for (i = 0; i < len; i++)
+    {
+        seed ^= seed << 13;
+        seed ^= seed >> 7;
+        seed ^= seed << 17;
+        buffer[i] = seed >> 24;
+    }
+}
+
+Status read_tune_args(int argc, char *argv[], TuneInfo *tuneInfo)
+{
+    int i;
+    tuneInfo->scratch_dir = ".";
+    tuneInfo->file_mb = TUNE_DEFAULT_FILE_MB;
+
+    for (i = 2; i < argc; i++)
+    {
+        if (strncmp(argv[i], "--size-mb=", 10) == 0 && atoi(argv[i] + 10) > 0 && atoi(argv[i] + 10) < 4096)
+        {
+            tuneInfo->file_mb = atoi(argv[i] + 10);
+        }
+        else if (strncmp(argv[i], "--", 2) != 0 && strcmp(tuneInfo->scratch_dir, ".") == 0)
+        {
+            tuneInfo->scratch_dir = argv[i];
+        }
+        else
+        {
+            printf("ERROR: ❌ Unknown tune argument %s\n", argv[i]);
+            return e_failure;
+        }
+    }
+    return e_success;
+}
+
+// Fastest embed and extract kernels that agree with the reference one
+static Status tune_kernels(Profile *profile)
+{
+    size_t n = (size_t)TUNE_KERNEL_KB << 10;
+    char *data = malloc(n), *check = malloc(n);
+    char *cover = malloc(n * 8), *ref = malloc(n * 8);
+    double best_embed = 0, best_extract = 0;
+    const LsbKernel *kernels;
+    Status status = e_failure;
+    int count, i, r;
+
+    if (data == NULL || check == NULL || cover == NULL || ref == NULL)
+    {
+        fprintf(stderr, "ERROR: ❌ Out of memory for the kernel benchmark\n");
+        goto out;
+    }
+    kernels = lsb_kernels(&count);
+    fill_random(data, n, 1);
+    fill_random(ref, n * 8, 2);
+    kernels[0].embed(data, n, ref);
+
+    printf("[INFO] %-8s %12s %12s\n", "Kernel", "Embed MB/s", "Extract MB/s");
+    for (i = 0; i < count; i++)
+    {
+        double embed = 0, extract = 0;
+        fill_random(cover, n * 8, 2);
+        kernels[i].embed(data, n, cover);
+        kernels[i].extract(ref, n, check);
+        if (memcmp(cover, ref, n * 8) != 0 || memcmp(check, data, n) != 0)
+        {
+            printf("[INFO] %-8s disagrees with %s; skipped\n", kernels[i].name, kernels[0].name);
+            continue;
+        }
+        for (r = 0; r < TUNE_ROUNDS; r++)
+        {
+            double t0 = now(), t1, t2;
+            kernels[i].embed(data, n, cover);
+            t1 = now();
+            kernels[i].extract(cover, n, check);
+            t2 = now();
+            if (n * 8 / (t1 - t0) / 1e6 > embed)
+            {
+                embed = n * 8 / (t1 - t0) / 1e6;
+            }
+            if (n * 8 / (t2 - t1) / 1e6 > extract)
+            {
+                extract = n * 8 / (t2 - t1) / 1e6;
+            }
+        }
+        printf("[INFO] %-8s %12.0f %12.0f\n", kernels[i].name, embed, extract);
+        if (embed > best_embed)
+        {
+            best_embed = embed;
+            snprintf(profile->embed, sizeof(profile->embed), "%s", kernels[i].name);
+        }
+        if (extract > best_extract)
+        {
+            best_extract = extract;
+            snprintf(profile->extract, sizeof(profile->extract), "%s", kernels[i].name);
+        }
+    }
+    status = lsb_select(profile->embed, profile->extract);
+
+out:
+    free(data);
+    free(check);
+    free(cover);
+    free(ref);
+    return status;
+}
+
+static void *embed_slice(void *arg)
+{
+    TuneSlice *slice = arg;
+    slice->kernel->embed(slice->data, slice->n, slice->cover);
+    return NULL;
+}
+
+// Throughput of the embed kernel on nthreads threads, best of a few rounds
+static double embed_rate(const LsbKernel *kernel, const char *data, char *cover, size_t n, int nthreads)
+{
+    pthread_t threads[TUNE_MAX_THREADS];
+    TuneSlice slices[TUNE_MAX_THREADS];
+    double best = 0;
+    int i, r, started;
+
+    for (r = 0; r < TUNE_ROUNDS; r++)
+    {
+        double t0 = now(), rate;
+        for (i = 0; i < nthreads; i++)
+        {
+            size_t from = n * i / nthreads, to = n * (i + 1) / nthreads;
+            slices[i] = (TuneSlice){kernel, data + from, cover + from * 8, to - from};
+        }
+        for (started = 1; started < nthreads; started++)
+        {
+            if (pthread_create(&threads[started], NULL, embed_slice, &slices[started]) != 0)
+            {
+                break;
+            }
+        }
+        // The calling thread takes the first slice, and any that did not start
+        embed_slice(&slices[0]);
+        for (i = started; i < nthreads; i++)
+        {
+            embed_slice(&slices[i]);
+        }
+        for (i = 1; i < started; i++)
+        {
+            pthread_join(threads[i], NULL);
+        }
+        rate = n * 8 / (now() - t0) / 1e6;
+        best = rate > best ? rate : best;
+    }
+    return best;
+}
+
+// Fewest threads that get within TUNE_THREAD_SLACK of the best throughput
+static Status tune_threads(Profile *profile)
+{
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    size_t n = ((size_t)TUNE_THREAD_MB << 20) / 8;
+    char *data = malloc(n), *cover = malloc(n * 8);
+    const LsbKernel *kernels, *kernel;
+    double rates[TUNE_MAX_THREADS + 1] = {0}, best = 0;
+    int counts[TUNE_MAX_THREADS + 1], tested = 0, count, i, nthreads;
+
+    if (data == NULL || cover == NULL)
+    {
+        fprintf(stderr, "ERROR: ❌ Out of memory for the thread benchmark\n");
+        free(data);
+        free(cover);
+        return e_failure;
+    }
+    // A profile naming a kernel this build lacks falls back to the scalar one
+    kernels = lsb_kernels(&count);
+    kernel = &kernels[0];
+    for (i = 0; i < count; i++)
+    {
+        kernel = strcmp(kernels[i].name, profile->embed) == 0 ? &kernels[i] : kernel;
+    }
+    fill_random(data, n, 3);
+    fill_random(cover, n * 8, 4);
+    cpus = cpus < 1 ? 1 : (cpus > TUNE_MAX_THREADS ? TUNE_MAX_THREADS : cpus);
+
+    // Powers of two, then the CPU count itself
+    for (i = 1;; i *= 2)
+    {
+        nthreads = i < cpus ? i : cpus;
+        counts[tested] = nthreads;
+        rates[tested] = embed_rate(kernel, data, cover, n, nthreads);
+        printf("[INFO] %2d thread(s): %8.0f MB/s\n", nthreads, rates[tested]);
+        best = rates[tested] > best ? rates[tested] : best;
+        tested++;
+        if (nthreads == cpus)
+        {
+            break;
+        }
+    }
+    i = 0;
+    while (i < tested - 1 && rates[i] < best * TUNE_THREAD_SLACK)
+    {
+        i++;
+    }
+    profile->threads = counts[i];
+    free(data);
+    free(cover);
+    return e_success;
+}
+
+// Write the synthetic BMP and push it out of the page cache
+static Status write_synthetic_bmp(const char *path, uint file_mb)
+{
+    unsigned long long len = (unsigned long long)file_mb << 20;
+    unsigned char header[54] = {'B', 'M'};
+    int width = 4096, height = (len - 54) / (width * 3);
+    unsigned int data_size = width * 3 * height, file_size = data_size + 54, pixels = 54, info = 40;
+    unsigned short planes = 1, bpp = 24;
+    char *buffer = malloc(1 << 20);
+    unsigned long long written;
+    FILE *fptr;
+
+    if (buffer == NULL)
+    {
+        fprintf(stderr, "ERROR: ❌ Out of memory for the test image\n");
+        return e_failure;
+    }
+    fptr = fopen(path, "w");
+    if (fptr == NULL)
+    {
+        perror("fopen");
+        free(buffer);
+        return e_failure;
+    }
+    memcpy(header + 2, &file_size, 4);
+    memcpy(header + 10, &pixels, 4);
+    memcpy(header + 14, &info, 4);
+    memcpy(header + 18, &width, 4);
+    memcpy(header + 22, &height, 4);
+    memcpy(header + 26, &planes, 2);
+    memcpy(header + 28, &bpp, 2);
+    memcpy(header + 34, &data_size, 4);
+    if (fwrite(header, sizeof(header), 1, fptr) != 1)
+    {
+        perror("fwrite");
+        free(buffer);
+        fclose(fptr);
+        return e_failure;
+    }
+    for (written = 0; written < data_size; written += 1 << 20)
+    {
+        size_t n = data_size - written < (1 << 20) ? data_size - written : (1 << 20);
+        fill_random(buffer, n, written + 5);
+        if (fwrite(buffer, n, 1, fptr) != 1)
+        {
+            perror("fwrite");
+            break;
+        }
+    }
+    free(buffer);
+    if (written < data_size || fflush(fptr) != 0 || fdatasync(fileno(fptr)) != 0)
+    {
+        fclose(fptr);
+        return e_failure;
+    }
+    posix_fadvise(fileno(fptr), 0, 0, POSIX_FADV_DONTNEED);
+    return fclose(fptr) == 0 ? e_success : e_failure;
+}
+
+// Middle stage of the I/O rounds: embed a block's worth of payload
+static Status tune_work(void *ctx, PipeBlock *block)
+{
+    lsb_embed(ctx, block->len / 8, block->data);
+    return e_success;
+}
+
+// Stream the synthetic BMP through the pipeline from a cold cache; MB per second
+static double pipeline_rate(const char *in_path, const char *out_path, uint block_kb, char *payload)
+{
+    Pipeline pl;
+    double t0, rate = 0;
+    FILE *in = fopen(in_path, "r"), *out = fopen(out_path, "w");
+
+    if (in != NULL && out != NULL)
+    {
+        posix_fadvise(fileno(in), 0, 0, POSIX_FADV_DONTNEED);
+        memset(&pl, 0, sizeof(pl));
+        pl.in = in;
+        pl.out = out;
+        pl.end = -1;
+        pl.block_size = (size_t)block_kb << 10;
+        pl.work = tune_work;
+        pl.ctx = payload;
+        t0 = now();
+        if (pipeline_run(&pl) == e_success && fflush(out) == 0 && fdatasync(fileno(out)) == 0)
+        {
+            rate = pl.bytes_in / (now() - t0) / 1e6;
+        }
+        posix_fadvise(fileno(out), 0, 0, POSIX_FADV_DONTNEED);
+    }
+    if (in != NULL)
+    {
+        fclose(in);
+    }
+    if (out != NULL)
+    {
+        fclose(out);
+    }
+    return rate;
+}
+
+// Fastest pipeline block size on the scratch volume
+static Status tune_block_size(Profile *profile, const TuneInfo *tuneInfo)
+{
+    char in_path[PATH_MAX], out_path[PATH_MAX];
+    char *payload = calloc(((size_t)block_sizes_kb[sizeof(block_sizes_kb) / sizeof(block_sizes_kb[0]) - 1] << 10) / 8 + PIPELINE_BLOCK_SLACK, 1);
+    double best = 0;
+    size_t i;
+
+    snprintf(in_path, sizeof(in_path), "%s/stego-tune.%ld.bmp", tuneInfo->scratch_dir, (long)getpid());
+    snprintf(out_path, sizeof(out_path), "%s/stego-tune.%ld.out.bmp", tuneInfo->scratch_dir, (long)getpid());
+    if (payload == NULL || write_synthetic_bmp(in_path, tuneInfo->file_mb) == e_failure)
+    {
+        fprintf(stderr, "ERROR: ❌ Unable to write a %u MB test image in %s\n", tuneInfo->file_mb, tuneInfo->scratch_dir);
+        unlink(in_path);
+        free(payload);
+        return e_failure;
+    }
+    for (i = 0; i < sizeof(block_sizes_kb) / sizeof(block_sizes_kb[0]); i++)
+    {
+        double rate = pipeline_rate(in_path, out_path, block_sizes_kb[i], payload);
+        printf("[INFO] %5u KB blocks: %8.0f MB/s\n", block_sizes_kb[i], rate);
+        if (rate > best)
+        {
+            best = rate;
+            profile->block_kb = block_sizes_kb[i];
+        }
+    }
+    unlink(in_path);
+    unlink(out_path);
+    free(payload);
+    return best > 0 ? e_success : e_failure;
+}
+
+Status do_tune(TuneInfo *tuneInfo)
+{
+    Profile profile = *profile_load();
+
+    printf("[INFO] Benchmarking LSB kernels\n");
+    if (tune_kernels(&profile) == e_failure)
+    {
+        return e_failure;
+    }
+    printf("[INFO] ✅ Embed %s, extract %s\n\n", profile.embed, profile.extract);
+
+    printf("[INFO] Benchmarking worker threads\n");
+    if (tune_threads(&profile) == e_failure)
+    {
+        return e_failure;
+    }
+    printf("[INFO] ✅ %d thread(s)\n\n", profile.threads);
+
+    printf("[INFO] Benchmarking pipeline block sizes on %s with a %u MB image\n", tuneInfo->scratch_dir, tuneInfo->file_mb);
+    if (tune_block_size(&profile, tuneInfo) == e_failure)
+    {
+        return e_failure;
+    }
+    printf("[INFO] ✅ %u KB blocks\n\n", profile.block_kb);
+
+    return profile_save(&profile);
+}
@@ -0,0 +1,37 @@
+#ifndef TUNE_H
+#define TUNE_H
+
+#include "types.h" // User-defined data types
+
+/*
+ * tune: short microbenchmarks that write this host's profile.
+ *  1. Every LSB kernel embeds into and extracts from an in-memory cover;
+ *     the fastest embed and extract that match the reference kernel win.
+ *  2. The chosen embed kernel runs on 1, 2, 4, ... CPUs threads over a
+ *     buffer larger than the caches; the fewest threads within 10% of the
+ *     best throughput win.
+ *  3. A synthetic BMP in the scratch directory is streamed through the
+ *     pipeline from a cold page cache at several block sizes; the
+ *     fastest block size wins.
+ */
+
+#define TUNE_DEFAULT_FILE_MB 128
+#define TUNE_KERNEL_KB 512  // Payload bytes per kernel round (the cover is 8 times that)
+#define TUNE_THREAD_MB 64   // Cover bytes for the thread scaling rounds
+#define TUNE_ROUNDS 5
+#define TUNE_MAX_THREADS 64
+#define TUNE_THREAD_SLACK 0.9
+
+typedef struct _TuneInfo
+{
+    const char *scratch_dir; // Where the synthetic BMP goes; the volume being tuned for
+    uint file_mb;            // Size of the synthetic BMP
+} TuneInfo;
+
+/* Read [scratch_dir] [--size-mb=N], N below 4096 so the BMP size field holds it */
+Status read_tune_args(int argc, char *argv[], TuneInfo *tuneInfo);
+
+/* Run the benchmarks and save the profile */
+Status do_tune(TuneInfo *tuneInfo);
+
+#endif
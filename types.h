@@ -15,6 +15,10 @@ typedef enum
 {
     e_encode,
     e_decode,
+    e_index,
+    e_fanout,
+    e_tune,
+    e_watch,
     e_unsupported
 } OperationType;
 
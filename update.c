@@ -0,0 +1,348 @@
+/*
+Documentation
+Name       :G Gangadhar
+Date       :30/07/2025
+Description:Steganography project
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/random.h>
+#include "checksum.h"
+#include "common.h"
+#include "decode.h"
+#include "encode.h"
+#include "lsb.h"
+#include "matrix.h"
+#include "update.h"
+#include "types.h"
+
+// Cover bytes used by size bytes of secret data plus its trailer
+static unsigned long long payload_region_size(uint size, int k, int flags)
+{
+    unsigned long long region = k ? matrix_cover_bytes(k, size) : (unsigned long long)size * 8;
+    if (flags & FLAG_CRC)
+    {
+        region += 32;
+    }
+    return region;
+}
+
+// Replace the LSBs of len cover bytes with random bits, so nothing of an old payload stays readable
+static Status scrub_lsbs(char *region, unsigned long long len)
+{
+    unsigned char bits[4096];
+    unsigned long long i = 0;
+
+    while (i < len)
+    {
+        unsigned long long chunk = len - i < sizeof(bits) * 8 ? len - i : sizeof(bits) * 8;
+        size_t want = (chunk + 7) / 8, got = 0;
+        while (got < want)
+        {
+            ssize_t n = getrandom(bits + got, want - got, 0);
+            if (n < 0)
+            {
+                perror("getrandom");
+                return e_failure;
+            }
+            got += n;
+        }
+        for (unsigned long long j = 0; j < chunk; j++)
+        {
+            region[i + j] = (region[i + j] & ~1) | ((bits[j / 8] >> (j % 8)) & 1);
+        }
+        i += chunk;
+    }
+    return e_success;
+}
+
+// End of the pixel array: the payload must not spill into whatever the file keeps after it
+static unsigned long long get_pixel_array_end(FILE *fptr_image)
+{
+    unsigned char field[4];
+    if (fseek(fptr_image, 10, SEEK_SET) != 0 || fread(field, 4, 1, fptr_image) != 1)
+    {
+        return 0;
+    }
+    uint pixel_offset = field[0] | (field[1] << 8) | (field[2] << 16) | ((uint)field[3] << 24);
+    return pixel_offset + get_image_size_for_bmp(fptr_image);
+}
+
+// Embed data into an in-memory payload region
+static void embed_region(const char *data, uint size, int k, char *region)
+{
+    if (k)
+    {
+        matrix_embed_buffer(data, size, k, region);
+        return;
+    }
+    lsb_embed(data, size, region);
+}
+
+// Extract data from an in-memory payload region
+static void extract_region(char *region, uint size, int k, char *data)
+{
+    if (k)
+    {
+        matrix_extract_buffer(region, size, k, data);
+        return;
+    }
+    lsb_extract(region, size, data);
+}
+
+// Write only the runs where the buffers differ, merging runs separated by small gaps
+Status write_changed_runs(FILE *fptr, long base, const char *old_buf, const char *new_buf, size_t len, unsigned long long *written)
+{
+    size_t i = 0, j, last;
+    while (i < len)
+    {
+        if (old_buf[i] == new_buf[i])
+        {
+            i++;
+            continue;
+        }
+        last = i;
+        for (j = i + 1; j < len && j - last <= UPDATE_MERGE_GAP; j++)
+        {
+            if (old_buf[j] != new_buf[j])
+            {
+                last = j;
+            }
+        }
+        if (fseek(fptr, base + i, SEEK_SET) != 0 || fwrite(new_buf + i, last + 1 - i, 1, fptr) != 1)
+        {
+            fprintf(stderr, "ERROR: ❌ Failed to write changed bytes at offset %ld\n", base + (long)i);
+            return e_failure;
+        }
+        *written += last + 1 - i;
+        i = last + 1;
+    }
+    return e_success;
+}
+
+// Open the stego image for in-place writing and the new secret for reading
+static Status open_update_files(EncodeInfo *encInfo)
+{
+    encInfo->fptr_stego_image = fopen(encInfo->stego_image_fname, "r+");
+    if (encInfo->fptr_stego_image == NULL)
+    {
+        perror("fopen");
+        fprintf(stderr, "ERROR: ❌ Unable to open file %s\n", encInfo->stego_image_fname);
+        return e_failure;
+    }
+    encInfo->fptr_secret = fopen(encInfo->secret_fname, "r");
+    if (encInfo->fptr_secret == NULL)
+    {
+        perror("fopen");
+        fprintf(stderr, "ERROR: ❌ Unable to open file %s\n", encInfo->secret_fname);
+        return e_failure;
+    }
+    return e_success;
+}
+
+// Read the existing payload header with the decoder's own steps
+static Status read_payload_header(EncodeInfo *encInfo, DecodeInfo *decInfo)
+{
+    memset(decInfo, 0, sizeof(*decInfo));
+    decInfo->stego_image_fname = encInfo->stego_image_fname;
+    decInfo->fptr_stego_image = encInfo->fptr_stego_image;
+
+    if (decode_magic_string(decInfo) == e_failure)
+    {
+        printf("ERROR: ❌ %s does not carry a payload to update\n", encInfo->stego_image_fname);
+        return e_failure;
+    }
+    if (decInfo->fptr_image_file != NULL)
+    {
+        // The image stays open through encInfo; only the lane is dropped
+        fclose(decInfo->fptr_stego_image);
+        decInfo->fptr_stego_image = decInfo->fptr_image_file;
+        printf("ERROR: ❌ %s carries its payload in a channel subset; re-encode it from its cover instead\n", encInfo->stego_image_fname);
+        return e_failure;
+    }
+    if (decode_secret_file_extn_size(decInfo) == e_failure ||
+        decInfo->secret_file_extn_size >= MAX_FILE_SUFFIX + 1 ||
+        decode_secret_file_extn(decInfo) == e_failure ||
+        decode_secret_file_size(decInfo) == e_failure ||
+        decInfo->size_secret_file < 0)
+    {
+        printf("ERROR: ❌ Corrupt payload header in %s\n", encInfo->stego_image_fname);
+        return e_failure;
+    }
+    return e_success;
+}
+
+// Append to or replace the payload of an existing stego image, in place
+Status do_update(EncodeInfo *encInfo)
+{
+    DecodeInfo decInfo;
+    Status status = e_failure;
+    char *secret = NULL, *old_buf = NULL, *new_buf = NULL, *old_data = NULL, *new_data = NULL;
+    char hdr_old[MAX_FILE_SUFFIX * 8 + 64], hdr_new[sizeof(hdr_old)];
+    unsigned long long written = 0;
+
+    printf("[INFO] Opening requried files\n");
+    if (open_update_files(encInfo) == e_failure)
+    {
+        return e_failure;
+    }
+    printf("[INFO] ✅ Done\n\n");
+
+    printf("[INFO] Reading payload header of %s\n", encInfo->stego_image_fname);
+    if (read_payload_header(encInfo, &decInfo) == e_failure)
+    {
+        return e_failure;
+    }
+    int flags = decInfo.stego_flags;
+    if (flags & FLAG_ADAPTIVE)
+    {
+        printf("ERROR: ❌ %s is adaptively embedded; re-encode it from its cover instead\n", encInfo->stego_image_fname);
+        return e_failure;
+    }
+    int k = (flags & FLAG_MATRIX) ? (flags & FLAG_MATRIX_K_MASK) >> FLAG_MATRIX_K_SHIFT : 0;
+    uint extn_size = decInfo.secret_file_extn_size;
+    long extn_at = decInfo.payload_offset + strlen(MAGIC_STRING) * 8 + 32;
+    long data_at = extn_at + extn_size * 8 + 32;
+    uint old_size = decInfo.size_secret_file;
+    printf("[INFO] Payload: %s, %u bytes%s%s\n", decInfo.secret_fname, old_size,
+           k ? ", matrix embedded" : "", (flags & FLAG_CRC) ? ", with checksum" : "");
+    printf("[INFO] ✅ Done\n\n");
+
+    if (encInfo->update_mode == UPDATE_REPLACE && strlen(encInfo->extn_secret_file) != extn_size)
+    {
+        printf("ERROR: ❌ Extension %s does not fit the stored %s in place\n", encInfo->extn_secret_file, decInfo.secret_fname);
+        return e_failure;
+    }
+
+    // Size the old and new payload regions against the image
+    unsigned long long secret_size = get_file_size(encInfo->fptr_secret);
+    unsigned long long new_total = encInfo->update_mode == UPDATE_APPEND ? old_size + secret_size : secret_size;
+    unsigned long long file_size = get_file_size(encInfo->fptr_stego_image);
+    unsigned long long pixel_end = get_pixel_array_end(encInfo->fptr_stego_image);
+    pixel_end = pixel_end < file_size ? pixel_end : file_size;
+    if (new_total > MAX_SECRET_SIZE)
+    {
+        printf("ERROR: ❌ Payload would exceed the size field\n");
+        return e_failure;
+    }
+    uint new_size = new_total;
+    unsigned long long old_region = payload_region_size(old_size, k, flags);
+    unsigned long long new_region = payload_region_size(new_size, k, flags);
+    unsigned long long span = old_region > new_region ? old_region : new_region;
+    if (data_at + old_region > pixel_end)
+    {
+        printf("ERROR: ❌ Payload size field of %s points past the end of the image\n", encInfo->stego_image_fname);
+        return e_failure;
+    }
+    if (data_at + new_region > pixel_end)
+    {
+        printf("ERROR: ❌ Insufficient image capacity for %u payload bytes\n", new_size);
+        return e_failure;
+    }
+
+    secret = malloc(secret_size + 1);
+    old_buf = malloc(span + 1);
+    new_buf = malloc(span + 1);
+    old_data = malloc(old_size + 1);
+    new_data = encInfo->update_mode == UPDATE_APPEND ? malloc(new_size + 1) : secret;
+    if (secret == NULL || old_buf == NULL || new_buf == NULL || old_data == NULL || new_data == NULL)
+    {
+        fprintf(stderr, "ERROR: ❌ Out of memory for a %llu byte payload region\n", span);
+        goto out;
+    }
+
+    // Read the secret and the payload region once
+    rewind(encInfo->fptr_secret);
+    if (secret_size > 0 && fread(secret, secret_size, 1, encInfo->fptr_secret) != 1)
+    {
+        fprintf(stderr, "ERROR: ❌ Failed to read %llu bytes from secret file.\n", secret_size);
+        goto out;
+    }
+    if (fseek(encInfo->fptr_stego_image, extn_at, SEEK_SET) != 0 ||
+        fread(hdr_old, data_at - extn_at, 1, encInfo->fptr_stego_image) != 1 ||
+        fread(old_buf, span, 1, encInfo->fptr_stego_image) != 1)
+    {
+        fprintf(stderr, "ERROR: ❌ Failed to read the payload region of %s\n", encInfo->stego_image_fname);
+        goto out;
+    }
+
+    // Build the new payload and embed it into a copy of the region
+    printf("[INFO] %s %s into %s\n", encInfo->update_mode == UPDATE_APPEND ? "Appending" : "Updating",
+           encInfo->secret_fname, encInfo->stego_image_fname);
+    extract_region(old_buf, old_size, k, old_data);
+    if (encInfo->update_mode == UPDATE_APPEND)
+    {
+        memcpy(new_data, old_data, old_size);
+        memcpy(new_data + old_size, secret, secret_size);
+    }
+    memcpy(new_buf, old_buf, span);
+    embed_region(new_data, new_size, k, new_buf);
+    encInfo->secret_crc = crc32_update(0, new_data, new_size);
+    if (flags & FLAG_CRC)
+    {
+        encode_int_to_lsb(encInfo->secret_crc, new_buf + new_region - 32);
+    }
+    // A shorter payload must not leave the tail of the old one behind
+    if (old_region > new_region && scrub_lsbs(new_buf + new_region, old_region - new_region) == e_failure)
+    {
+        goto out;
+    }
+
+    // Size field, and the extension bytes when updating
+    memcpy(hdr_new, hdr_old, data_at - extn_at);
+    if (encInfo->update_mode == UPDATE_REPLACE)
+    {
+        for (uint i = 0; i < extn_size; i++)
+        {
+            encode_byte_to_lsb(encInfo->extn_secret_file[i], hdr_new + i * 8);
+        }
+    }
+    encode_int_to_lsb(new_size, hdr_new + extn_size * 8);
+
+    if (encInfo->verify)
+    {
+        // Re-extract the new payload from the buffer that is about to be written
+        char *check = malloc(new_size + 1);
+        int crc = encInfo->secret_crc;
+        if (check == NULL)
+        {
+            goto out;
+        }
+        extract_region(new_buf, new_size, k, check);
+        verify_window(&encInfo->verify_info, new_data, check, new_size);
+        free(check);
+        if (flags & FLAG_CRC)
+        {
+            decode_int_from_lsb(&crc, new_buf + new_region - 32);
+        }
+        if (verify_result(&encInfo->verify_info) == e_failure || (uint)crc != encInfo->secret_crc)
+        {
+            printf("ERROR: ❌ Verification failed: %u mismatched bytes\n", encInfo->verify_info.mismatches);
+            goto out;
+        }
+        printf("[INFO] ✅ Verified %llu bytes\n", encInfo->verify_info.bytes);
+    }
+
+    // Only the bytes that changed go back to disk
+    if (write_changed_runs(encInfo->fptr_stego_image, extn_at, hdr_old, hdr_new, data_at - extn_at, &written) == e_failure ||
+        write_changed_runs(encInfo->fptr_stego_image, data_at, old_buf, new_buf, span, &written) == e_failure ||
+        fflush(encInfo->fptr_stego_image) != 0)
+    {
+        goto out;
+    }
+    printf("[INFO] Payload is now %u bytes; rewrote %llu of %llu bytes\n", new_size, written, file_size);
+    printf("[INFO] ✅ Done\n\n");
+    status = e_success;
+
+out:
+    if (new_data != secret)
+    {
+        free(new_data);
+    }
+    free(secret);
+    free(old_buf);
+    free(new_buf);
+    free(old_data);
+    return status;
+}
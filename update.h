@@ -0,0 +1,26 @@
+#ifndef UPDATE_H
+#define UPDATE_H
+
+#include "encode.h" // EncodeInfo
+#include "types.h"  // User-defined data types
+
+/*
+ * In-place append/update of the payload of an existing stego image.
+ * The payload region is read once, the new content is embedded into a
+ * copy, and only the byte runs that actually differ are written back.
+ */
+
+#define UPDATE_NONE 0
+#define UPDATE_APPEND 1  // Add the secret file's bytes after the current payload
+#define UPDATE_REPLACE 2 // Replace the payload with the secret file's bytes
+
+/* Runs of changed bytes closer than this are written with one fwrite */
+#define UPDATE_MERGE_GAP 64
+
+/* Append to or update the payload of encInfo->stego_image_fname in place */
+Status do_update(EncodeInfo *encInfo);
+
+/* Write the byte runs where new_buf differs from old_buf at file offset base */
+Status write_changed_runs(FILE *fptr, long base, const char *old_buf, const char *new_buf, size_t len, unsigned long long *written);
+
+#endif
@@ -0,0 +1,640 @@
+/*
+Documentation
+Name       :G Gangadhar
+Date       :30/07/2025
+Description:Steganography project
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <dirent.h>
+#include <poll.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <sys/signalfd.h>
+#include <sys/stat.h>
+#include "async.h"
+#include "encode.h"
+#include "update.h"
+#include "watch.h"
+#include "types.h"
+
+// Milliseconds on the monotonic clock
+static long long now_ms(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000LL + ts.tv_nsec / 1000000;
+}
+
+// Split watch options from encode options and check the directories
+Status read_and_validate_watch_args(int argc, char *argv[], WatchInfo *watchInfo)
+{
+    char *enc_argv[JOB_MAX_OPTIONS + 4];
+    int enc_argc = 2, i, dirs = 0;
+    EncodeInfo check;
+    struct stat spool_st, out_st;
+
+    memset(watchInfo, 0, sizeof(*watchInfo));
+    watchInfo->batch_ms = WATCH_DEFAULT_BATCH_MS;
+    watchInfo->max_batch = WATCH_DEFAULT_MAX_BATCH;
+    enc_argv[0] = argv[0];
+    enc_argv[1] = "-e";
+    for (i = 2; i < argc; i++)
+    {
+        if (strncmp(argv[i], "--batch-ms=", 11) == 0 && atoi(argv[i] + 11) > 0)
+        {
+            watchInfo->batch_ms = atoi(argv[i] + 11);
+        }
+        else if (strncmp(argv[i], "--max-batch=", 12) == 0 && atoi(argv[i] + 12) > 0)
+        {
+            watchInfo->max_batch = atoi(argv[i] + 12);
+        }
+        else if (strncmp(argv[i], "--metrics=", 10) == 0 && argv[i][10] != '\0')
+        {
+            snprintf(watchInfo->metrics_path, sizeof(watchInfo->metrics_path), "%s", argv[i] + 10);
+        }
+        else if (strncmp(argv[i], "--cache=", 8) == 0)
+        {
+            // Jobs of the pool never look up the cache
+            printf("ERROR: ❌ Watch mode cannot use --cache\n");
+            return e_failure;
+        }
+        else if (strncmp(argv[i], "--", 2) == 0)
+        {
+            if (enc_argc - 2 >= JOB_MAX_OPTIONS)
+            {
+                printf("ERROR: ❌ At most %d encode options\n", JOB_MAX_OPTIONS);
+                return e_failure;
+            }
+            watchInfo->options[enc_argc - 2] = argv[i];
+            enc_argv[enc_argc++] = argv[i];
+        }
+        else if (dirs++ == 0)
+        {
+            watchInfo->spool_dir = argv[i];
+        }
+        else if (dirs == 2)
+        {
+            watchInfo->out_dir = argv[i];
+        }
+        else
+        {
+            printf("ERROR: ❌ Unexpected argument %s\n", argv[i]);
+            return e_failure;
+        }
+    }
+    enc_argv[enc_argc] = NULL;
+
+    // Every job gets these options; reject what would fail each one of them
+    if (read_encode_options(&enc_argc, enc_argv, &check) == e_failure)
+    {
+        return e_failure;
+    }
+    if (check.update_mode != UPDATE_NONE || check.auto_cover_dir != NULL || check.resume)
+    {
+        printf("ERROR: ❌ Watch mode cannot use --append, --update, --auto-cover or --resume\n");
+        return e_failure;
+    }
+
+    if (watchInfo->spool_dir == NULL || watchInfo->out_dir == NULL)
+    {
+        printf("ERROR: ❌ A spool directory and an output directory are needed\n");
+        return e_failure;
+    }
+    if (stat(watchInfo->spool_dir, &spool_st) != 0 || !S_ISDIR(spool_st.st_mode) ||
+        stat(watchInfo->out_dir, &out_st) != 0 || !S_ISDIR(out_st.st_mode))
+    {
+        printf("ERROR: ❌ %s and %s must both be directories\n", watchInfo->spool_dir, watchInfo->out_dir);
+        return e_failure;
+    }
+    // Results written into the spool would be taken for new covers
+    if (spool_st.st_dev == out_st.st_dev && spool_st.st_ino == out_st.st_ino)
+    {
+        printf("ERROR: ❌ The output directory must not be the spool directory\n");
+        return e_failure;
+    }
+    if (watchInfo->metrics_path[0] == '\0')
+    {
+        snprintf(watchInfo->metrics_path, sizeof(watchInfo->metrics_path), "%s/%s", watchInfo->out_dir, WATCH_METRICS_FILE);
+    }
+    return e_success;
+}
+
+// Index of the latency bucket: bucket b holds latencies below 2^b ms
+static int latency_bucket(unsigned long long ms)
+{
+    int b = 0;
+    while (b < WATCH_LATENCY_BUCKETS - 1 && ms >= (1ULL << b))
+    {
+        b++;
+    }
+    return b;
+}
+
+// Upper bound of the bucket holding quantile q, no more than the slowest job
+static unsigned long long latency_quantile(const WatchInfo *watchInfo, double q)
+{
+    unsigned long long total = watchInfo->done + watchInfo->failed, seen = 0;
+    int b;
+
+    for (b = 0; b < WATCH_LATENCY_BUCKETS && total > 0; b++)
+    {
+        seen += watchInfo->latency_hist[b];
+        if (seen >= q * total)
+        {
+            return (1ULL << b) < watchInfo->latency_max_ms ? 1ULL << b : watchInfo->latency_max_ms;
+        }
+    }
+    return 0;
+}
+
+// Write the figures in Prometheus text format, replacing the file atomically
+static void write_metrics(WatchInfo *watchInfo, int print)
+{
+    char tmp_path[PATH_MAX + 16];
+    FILE *fptr;
+
+    snprintf(tmp_path, sizeof(tmp_path), "%s.%ld.tmp", watchInfo->metrics_path, (long)getpid());
+    pthread_mutex_lock(&watchInfo->lock);
+    unsigned long long finished = watchInfo->done + watchInfo->failed;
+    unsigned long long p50 = latency_quantile(watchInfo, 0.5), p95 = latency_quantile(watchInfo, 0.95);
+    int depth = watchInfo->batch_count + watchInfo->queue_count;
+    int in_flight = atomic_load(&watchInfo->in_flight);
+    fptr = fopen(tmp_path, "w");
+    if (fptr != NULL)
+    {
+        fprintf(fptr, "stego_watch_queue_depth %d\n", depth);
+        fprintf(fptr, "stego_watch_in_flight %d\n", in_flight);
+        fprintf(fptr, "stego_watch_jobs_total{result=\"done\"} %llu\n", watchInfo->done);
+        fprintf(fptr, "stego_watch_jobs_total{result=\"failed\"} %llu\n", watchInfo->failed);
+        fprintf(fptr, "stego_watch_jobs_total{result=\"cancelled\"} %llu\n", watchInfo->cancelled);
+        fprintf(fptr, "stego_watch_batches_total %llu\n", watchInfo->batches);
+        fprintf(fptr, "stego_watch_batched_pairs_total %llu\n", watchInfo->batched);
+        fprintf(fptr, "stego_watch_latency_ms{quantile=\"0.5\"} %llu\n", p50);
+        fprintf(fptr, "stego_watch_latency_ms{quantile=\"0.95\"} %llu\n", p95);
+        fprintf(fptr, "stego_watch_latency_ms_max %llu\n", watchInfo->latency_max_ms);
+        fprintf(fptr, "stego_watch_latency_ms_sum %llu\n", watchInfo->latency_sum_ms);
+        fprintf(fptr, "stego_watch_latency_ms_count %llu\n", finished);
+    }
+    if (print)
+    {
+        printf("[INFO] Watch: %d queued, %d in flight, %llu done, %llu failed, %llu batches (%.1f pairs each), "
+               "latency p50 < %llu ms, p95 < %llu ms, max %llu ms\n",
+               depth, in_flight, watchInfo->done, watchInfo->failed, watchInfo->batches,
+               watchInfo->batches ? (double)watchInfo->batched / watchInfo->batches : 0.0, p50, p95, watchInfo->latency_max_ms);
+    }
+    pthread_mutex_unlock(&watchInfo->lock);
+    if (fptr == NULL || fclose(fptr) != 0 || rename(tmp_path, watchInfo->metrics_path) != 0)
+    {
+        perror("metrics");
+        unlink(tmp_path);
+    }
+}
+
+// Take a job off the active list; the caller holds the lock
+static void unlink_active(WatchInfo *watchInfo, WatchJob *wj)
+{
+    if (wj->active_prev != NULL)
+    {
+        wj->active_prev->active_next = wj->active_next;
+    }
+    else
+    {
+        watchInfo->active = wj->active_next;
+    }
+    if (wj->active_next != NULL)
+    {
+        wj->active_next->active_prev = wj->active_prev;
+    }
+}
+
+// Whether a job for this base name is batched, queued or in flight
+static int name_active(WatchInfo *watchInfo, const char *name)
+{
+    WatchJob *wj;
+    int found = 0;
+
+    pthread_mutex_lock(&watchInfo->lock);
+    for (wj = watchInfo->active; wj != NULL && !found; wj = wj->active_next)
+    {
+        found = strcmp(wj->name, name) == 0;
+    }
+    pthread_mutex_unlock(&watchInfo->lock);
+    return found;
+}
+
+// Runs on a worker thread: publish the result, clear the spool and count the job
+static void job_finished(StegoJob *job, JobState state, void *arg)
+{
+    WatchJob *wj = arg;
+    WatchInfo *watchInfo = wj->watch;
+    char failed_path[PATH_MAX + 8];
+    unsigned long long latency;
+    uint64_t one = 1;
+
+    (void)job;
+    if (state == e_job_done && rename(wj->tmp_path, wj->out_path) != 0)
+    {
+        perror("rename");
+        state = e_job_failed;
+    }
+    if (state == e_job_done)
+    {
+        printf("[INFO] ✅ %s -> %s\n", wj->name, wj->out_path);
+        unlink(wj->cover);
+        unlink(wj->secret);
+    }
+    else if (state != e_job_cancelled)
+    {
+        // Out of the way of the next pair with the same name, and kept for a look
+        fprintf(stderr, "ERROR: ❌ Failed to encode %s; inputs renamed to *.failed\n", wj->name);
+        unlink(wj->tmp_path);
+        snprintf(failed_path, sizeof(failed_path), "%s.failed", wj->cover);
+        rename(wj->cover, failed_path);
+        snprintf(failed_path, sizeof(failed_path), "%s.failed", wj->secret);
+        rename(wj->secret, failed_path);
+    }
+
+    latency = now_ms() - wj->ready_ms;
+    pthread_mutex_lock(&watchInfo->lock);
+    unlink_active(watchInfo, wj);
+    if (state == e_job_cancelled)
+    {
+        watchInfo->cancelled++;
+    }
+    else
+    {
+        if (state == e_job_done)
+        {
+            watchInfo->done++;
+        }
+        else
+        {
+            watchInfo->failed++;
+        }
+        watchInfo->latency_sum_ms += latency;
+        watchInfo->latency_max_ms = latency > watchInfo->latency_max_ms ? latency : watchInfo->latency_max_ms;
+        watchInfo->latency_hist[latency_bucket(latency)]++;
+    }
+    pthread_mutex_unlock(&watchInfo->lock);
+    atomic_fetch_sub(&watchInfo->in_flight, 1);
+    free(wj);
+    if (write(watchInfo->wake_fd, &one, sizeof(one)) != sizeof(one))
+    {
+        perror("eventfd");
+    }
+}
+
+// Half-complete pair with this base name, added when missing
+static WatchEntry *find_entry(WatchInfo *watchInfo, const char *name)
+{
+    int i;
+    for (i = 0; i < watchInfo->entry_count; i++)
+    {
+        if (strcmp(watchInfo->entries[i].name, name) == 0)
+        {
+            return &watchInfo->entries[i];
+        }
+    }
+    if (watchInfo->entry_count == watchInfo->entry_size)
+    {
+        int size = watchInfo->entry_size ? watchInfo->entry_size * 2 : 64;
+        WatchEntry *entries = realloc(watchInfo->entries, size * sizeof(WatchEntry));
+        if (entries == NULL)
+        {
+            return NULL;
+        }
+        watchInfo->entries = entries;
+        watchInfo->entry_size = size;
+    }
+    WatchEntry *entry = &watchInfo->entries[watchInfo->entry_count++];
+    memset(entry, 0, sizeof(*entry));
+    snprintf(entry->name, sizeof(entry->name), "%s", name);
+    return entry;
+}
+
+// A complete pair becomes a job in the batch being collected
+static void add_to_batch(WatchInfo *watchInfo, WatchEntry *entry)
+{
+    WatchJob *wj = calloc(1, sizeof(WatchJob));
+    long long now = now_ms();
+
+    if (wj == NULL)
+    {
+        fprintf(stderr, "ERROR: ❌ Out of memory for the %s job\n", entry->name);
+        return;
+    }
+    snprintf(wj->name, sizeof(wj->name), "%s", entry->name);
+    snprintf(wj->cover, sizeof(wj->cover), "%s/%s.bmp", watchInfo->spool_dir, entry->name);
+    snprintf(wj->secret, sizeof(wj->secret), "%s/%s%s", watchInfo->spool_dir, entry->name, entry->secret_extn);
+    snprintf(wj->tmp_path, sizeof(wj->tmp_path), "%s/.%s.%ld.tmp.bmp", watchInfo->out_dir, entry->name, (long)getpid());
+    snprintf(wj->out_path, sizeof(wj->out_path), "%s/%s.bmp", watchInfo->out_dir, entry->name);
+    wj->ready_ms = now;
+    wj->watch = watchInfo;
+    pthread_mutex_lock(&watchInfo->lock);
+    wj->active_next = watchInfo->active;
+    if (watchInfo->active != NULL)
+    {
+        watchInfo->active->active_prev = wj;
+    }
+    watchInfo->active = wj;
+    pthread_mutex_unlock(&watchInfo->lock);
+    if (watchInfo->batch_head == NULL)
+    {
+        watchInfo->batch_head = wj;
+        watchInfo->batch_start_ms = now;
+    }
+    else
+    {
+        watchInfo->batch_tail->next = wj;
+    }
+    watchInfo->batch_tail = wj;
+    watchInfo->batch_count++;
+
+    // The entry is done with; the last one takes its slot
+    *entry = watchInfo->entries[--watchInfo->entry_count];
+}
+
+// Note a complete spool file; dot files, results of failed jobs and other names are ignored
+static void note_file(WatchInfo *watchInfo, const char *fname)
+{
+    const char *dot = strrchr(fname, '.');
+    char name[NAME_MAX + 1];
+    WatchEntry *entry;
+    int is_cover;
+
+    if (fname[0] == '.' || dot == NULL || dot == fname || dot - fname > NAME_MAX)
+    {
+        return;
+    }
+    is_cover = strcmp(dot, ".bmp") == 0;
+    if (!is_cover && strcmp(dot, ".txt") != 0 && strcmp(dot, ".c") != 0 && strcmp(dot, ".sh") != 0)
+    {
+        return;
+    }
+    memcpy(name, fname, dot - fname);
+    name[dot - fname] = '\0';
+    // The startup scan and a rescan after an overflow can report a pair that already has its job
+    if (name_active(watchInfo, name) || (entry = find_entry(watchInfo, name)) == NULL)
+    {
+        return;
+    }
+    if (is_cover)
+    {
+        entry->cover = 1;
+    }
+    else
+    {
+        strcpy(entry->secret_extn, dot);
+    }
+    watchInfo->last_event_ms = now_ms();
+    if (entry->cover && entry->secret_extn[0] != '\0')
+    {
+        // A stale event may name a file that is gone again; only a pair present on disk becomes a job
+        char path[PATH_MAX];
+        snprintf(path, sizeof(path), "%s/%s.bmp", watchInfo->spool_dir, name);
+        entry->cover = access(path, R_OK) == 0;
+        snprintf(path, sizeof(path), "%s/%s%s", watchInfo->spool_dir, name, entry->secret_extn);
+        if (access(path, R_OK) != 0)
+        {
+            entry->secret_extn[0] = '\0';
+        }
+        if (entry->cover && entry->secret_extn[0] != '\0')
+        {
+            add_to_batch(watchInfo, entry);
+        }
+    }
+}
+
+// Everything already in the spool is complete
+static void scan_spool(WatchInfo *watchInfo)
+{
+    DIR *dir = opendir(watchInfo->spool_dir);
+    struct dirent *de;
+
+    if (dir == NULL)
+    {
+        perror("opendir");
+        return;
+    }
+    while ((de = readdir(dir)) != NULL)
+    {
+        if (de->d_type == DT_REG || de->d_type == DT_UNKNOWN)
+        {
+            note_file(watchInfo, de->d_name);
+        }
+    }
+    closedir(dir);
+}
+
+// Drain the inotify queue; returns 0 once the spool itself is gone
+static int read_events(WatchInfo *watchInfo, int fd)
+{
+    char buf[16 * (sizeof(struct inotify_event) + NAME_MAX + 1)] __attribute__((aligned(__alignof__(struct inotify_event))));
+    ssize_t len;
+    int alive = 1;
+
+    while ((len = read(fd, buf, sizeof(buf))) > 0)
+    {
+        char *p;
+        for (p = buf; p < buf + len; p += sizeof(struct inotify_event) + ((struct inotify_event *)p)->len)
+        {
+            struct inotify_event *ev = (struct inotify_event *)p;
+            if (ev->mask & IN_Q_OVERFLOW)
+            {
+                // Events were dropped; the directory itself is the truth
+                printf("[INFO] inotify queue overflowed, rescanning %s\n", watchInfo->spool_dir);
+                scan_spool(watchInfo);
+            }
+            else if (ev->mask & (IN_DELETE_SELF | IN_MOVE_SELF | IN_IGNORED))
+            {
+                alive = 0;
+            }
+            else if (ev->len > 0 && !(ev->mask & IN_ISDIR))
+            {
+                note_file(watchInfo, ev->name);
+            }
+        }
+    }
+    return alive;
+}
+
+// Close the batch being collected: it joins the queue as a whole
+static void close_batch(WatchInfo *watchInfo)
+{
+    if (watchInfo->queue_head == NULL)
+    {
+        watchInfo->queue_head = watchInfo->batch_head;
+    }
+    else
+    {
+        watchInfo->queue_tail->next = watchInfo->batch_head;
+    }
+    watchInfo->queue_tail = watchInfo->batch_tail;
+    watchInfo->queue_count += watchInfo->batch_count;
+    pthread_mutex_lock(&watchInfo->lock);
+    watchInfo->batches++;
+    watchInfo->batched += watchInfo->batch_count;
+    pthread_mutex_unlock(&watchInfo->lock);
+    watchInfo->batch_head = watchInfo->batch_tail = NULL;
+    watchInfo->batch_count = 0;
+}
+
+// Hand queued jobs to the pool while it has room
+static void dispatch(WatchInfo *watchInfo)
+{
+    while (watchInfo->queue_head != NULL && atomic_load(&watchInfo->in_flight) < watchInfo->max_in_flight)
+    {
+        WatchJob *wj = watchInfo->queue_head;
+        watchInfo->queue_head = wj->next;
+        if (watchInfo->queue_head == NULL)
+        {
+            watchInfo->queue_tail = NULL;
+        }
+        watchInfo->queue_count--;
+        wj->next = NULL;
+
+        if (job_init_encode(&wj->job, wj->cover, wj->secret, wj->tmp_path, watchInfo->options) == e_failure)
+        {
+            // Counted and cleaned up like any other failed job
+            atomic_fetch_add(&watchInfo->in_flight, 1);
+            job_finished(&wj->job, e_job_failed, wj);
+            continue;
+        }
+        atomic_fetch_add(&watchInfo->in_flight, 1);
+        if (executor_submit(&watchInfo->executor, &wj->job, job_finished, wj, 0) == e_failure)
+        {
+            job_finished(&wj->job, e_job_failed, wj);
+        }
+    }
+}
+
+// Free jobs that never reached the pool; their pairs stay in the spool
+static void free_jobs(WatchInfo *watchInfo, WatchJob *wj)
+{
+    while (wj != NULL)
+    {
+        WatchJob *next = wj->next;
+        pthread_mutex_lock(&watchInfo->lock);
+        unlink_active(watchInfo, wj);
+        pthread_mutex_unlock(&watchInfo->lock);
+        free(wj);
+        wj = next;
+    }
+}
+
+Status do_watch(WatchInfo *watchInfo)
+{
+    struct pollfd fds[3];
+    sigset_t mask;
+    long long next_metrics;
+    int ifd, sfd, running = 1;
+    uint64_t count;
+
+    // Signals arrive on a descriptor, so no worker thread is interrupted by them
+    sigemptyset(&mask);
+    sigaddset(&mask, SIGINT);
+    sigaddset(&mask, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &mask, NULL);
+    sfd = signalfd(-1, &mask, SFD_CLOEXEC | SFD_NONBLOCK);
+    ifd = inotify_init1(IN_CLOEXEC | IN_NONBLOCK);
+    watchInfo->wake_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (sfd < 0 || ifd < 0 || watchInfo->wake_fd < 0 ||
+        inotify_add_watch(ifd, watchInfo->spool_dir, IN_CLOSE_WRITE | IN_MOVED_TO | IN_DELETE_SELF | IN_MOVE_SELF) < 0)
+    {
+        perror("watch");
+        return e_failure;
+    }
+    pthread_mutex_init(&watchInfo->lock, NULL);
+    atomic_init(&watchInfo->in_flight, 0);
+    if (executor_init(&watchInfo->executor, 0) == e_failure)
+    {
+        return e_failure;
+    }
+    watchInfo->max_in_flight = watchInfo->executor.nthreads * WATCH_JOBS_PER_THREAD;
+    printf("[INFO] Watching %s with %d workers, results in %s, metrics in %s\n", watchInfo->spool_dir,
+           watchInfo->executor.nthreads, watchInfo->out_dir, watchInfo->metrics_path);
+
+    // The watch is in place first, so a file closed during the scan is seen by one or the other
+    scan_spool(watchInfo);
+    next_metrics = now_ms() + WATCH_METRICS_MS;
+    fds[0].fd = sfd;
+    fds[1].fd = ifd;
+    fds[2].fd = watchInfo->wake_fd;
+    fds[0].events = fds[1].events = fds[2].events = POLLIN;
+
+    while (running)
+    {
+        long long now = now_ms();
+        long long wake = next_metrics;
+        if (watchInfo->batch_head != NULL)
+        {
+            long long quiet = watchInfo->last_event_ms + watchInfo->batch_ms;
+            long long oldest = watchInfo->batch_start_ms + (long long)WATCH_MAX_DELAY * watchInfo->batch_ms;
+            wake = quiet < wake ? quiet : wake;
+            wake = oldest < wake ? oldest : wake;
+        }
+        if (poll(fds, 3, wake > now ? (int)(wake - now) : 0) < 0 && errno != EINTR)
+        {
+            perror("poll");
+            break;
+        }
+        if (fds[0].revents & POLLIN)
+        {
+            struct signalfd_siginfo info;
+            if (read(sfd, &info, sizeof(info)) == sizeof(info))
+            {
+                printf("[INFO] Signal %u received, stopping\n", info.ssi_signo);
+            }
+            running = 0;
+        }
+        if ((fds[1].revents & POLLIN) && !read_events(watchInfo, ifd))
+        {
+            printf("ERROR: ❌ Spool directory %s went away\n", watchInfo->spool_dir);
+            running = 0;
+        }
+        if (fds[2].revents & POLLIN)
+        {
+            while (read(watchInfo->wake_fd, &count, sizeof(count)) == sizeof(count))
+            {
+            }
+        }
+
+        now = now_ms();
+        if (watchInfo->batch_head != NULL &&
+            (now >= watchInfo->last_event_ms + watchInfo->batch_ms || watchInfo->batch_count >= watchInfo->max_batch ||
+             now >= watchInfo->batch_start_ms + (long long)WATCH_MAX_DELAY * watchInfo->batch_ms))
+        {
+            close_batch(watchInfo);
+        }
+        if (running)
+        {
+            dispatch(watchInfo);
+        }
+        if (now >= next_metrics)
+        {
+            write_metrics(watchInfo, 1);
+            next_metrics = now + WATCH_METRICS_MS;
+        }
+    }
+
+    // Running jobs finish and publish; queued ones come back as cancelled
+    executor_shutdown(&watchInfo->executor);
+    free_jobs(watchInfo, watchInfo->batch_head);
+    free_jobs(watchInfo, watchInfo->queue_head);
+    watchInfo->batch_head = watchInfo->queue_head = NULL;
+    watchInfo->batch_count = watchInfo->queue_count = 0;
+    write_metrics(watchInfo, 1);
+    free(watchInfo->entries);
+    close(watchInfo->wake_fd);
+    close(ifd);
+    close(sfd);
+    pthread_mutex_destroy(&watchInfo->lock);
+    return e_success;
+}
@@ -0,0 +1,95 @@
+#ifndef WATCH_H
+#define WATCH_H
+
+#include <limits.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include "async.h"  // Executor, StegoJob
+#include "encode.h" // MAX_FILE_SUFFIX
+#include "types.h"  // User-defined data types
+
+/*
+ * Watch mode: encode cover/secret pairs as they land in a spool directory.
+ * A pair is <name>.bmp plus <name>.txt, .c or .sh; a file counts once it
+ * is closed after writing or renamed into the spool (IN_CLOSE_WRITE,
+ * IN_MOVED_TO), and files already there at startup count too.
+ * Completed pairs are collected into a batch until the spool has been
+ * quiet for --batch-ms, the batch is full, or its first pair has waited
+ * WATCH_MAX_DELAY batch windows; the batch then goes to the executor's
+ * worker pool, at most WATCH_JOBS_PER_THREAD jobs per worker at a time.
+ * Each result is encoded to a hidden temporary name in the output
+ * directory and renamed to <name>.bmp, so readers never see a partial
+ * image; the pair is then removed from the spool, or renamed to
+ * <file>.failed if it could not be encoded.
+ * Queue depth, throughput and latency (pair complete -> result renamed)
+ * are written to the metrics file every WATCH_METRICS_MS and on exit.
+ * SIGINT or SIGTERM stops watching, lets running jobs finish and leaves
+ * queued pairs in the spool for the next run.
+ */
+
+#define WATCH_DEFAULT_BATCH_MS 50
+#define WATCH_DEFAULT_MAX_BATCH 64
+#define WATCH_MAX_DELAY 20        // Batch windows the first pair of a batch may wait
+#define WATCH_JOBS_PER_THREAD 2
+#define WATCH_METRICS_MS 10000
+#define WATCH_METRICS_FILE ".stego-watch.metrics"
+#define WATCH_LATENCY_BUCKETS 32  // Powers of two milliseconds
+
+typedef struct _WatchJob
+{
+    StegoJob job;
+    char name[NAME_MAX + 1];        // Base name shared by cover and secret
+    char cover[PATH_MAX];
+    char secret[PATH_MAX];
+    char tmp_path[PATH_MAX];        // Where the job writes
+    char out_path[PATH_MAX];        // Where the result is published
+    long long ready_ms;             // When the pair was complete
+    struct _WatchInfo *watch;
+    struct _WatchJob *next;
+    struct _WatchJob *active_prev, *active_next; // Jobs not yet finished, batched to in flight
+} WatchJob;
+
+typedef struct _WatchEntry
+{
+    char name[NAME_MAX + 1];
+    int cover;                             // <name>.bmp is complete
+    char secret_extn[MAX_FILE_SUFFIX + 1]; // Extension of the complete secret, "" while none
+} WatchEntry;
+
+typedef struct _WatchInfo
+{
+    char *spool_dir;
+    char *out_dir;
+    char metrics_path[PATH_MAX];
+    char *options[JOB_MAX_OPTIONS + 1]; // Encode options for every job
+    int batch_ms;
+    int max_batch;
+
+    /* Main thread only */
+    Executor executor;
+    WatchEntry *entries;  // Half-complete pairs
+    int entry_count, entry_size;
+    WatchJob *batch_head, *batch_tail; // Batch being collected
+    int batch_count;
+    long long batch_start_ms, last_event_ms;
+    WatchJob *queue_head, *queue_tail; // Closed batches waiting for a worker
+    int queue_count;
+    int max_in_flight;
+
+    /* Shared with the job callbacks */
+    int wake_fd;                 // eventfd written when a job finishes
+    _Atomic int in_flight;
+    pthread_mutex_t lock;        // Guards the active list and the figures below
+    WatchJob *active;            // Every unfinished job, so a pair seen twice is not queued twice
+    unsigned long long done, failed, cancelled, batches, batched;
+    unsigned long long latency_sum_ms, latency_max_ms;
+    unsigned long long latency_hist[WATCH_LATENCY_BUCKETS];
+} WatchInfo;
+
+/* Read "<spool_dir> <output_dir> [encode options] [--batch-ms=N] [--max-batch=N] [--metrics=<file>]" */
+Status read_and_validate_watch_args(int argc, char *argv[], WatchInfo *watchInfo);
+
+/* Watch the spool until SIGINT or SIGTERM */
+Status do_watch(WatchInfo *watchInfo);
+
+#endif